@@ -0,0 +1,148 @@
+#include "AssignmentBackend.hpp"
+#include <limits>
+
+void HungarianBackend::solve(const CostRows& costs, AssignmentResult& result) {
+    int n = costs.size();
+    u.assign(n + 1, 0.0);
+    v.assign(n + 1, 0.0);
+    p.assign(n + 1, 0);
+    way.assign(n + 1, 0);
+    scratch.resize(n);
+
+    for (int i = 1; i <= n; i++) {
+        augment(costs, i);
+    }
+    finish(costs, result);
+}
+
+void HungarianBackend::resolve(const CostRows& costs, const std::vector<int>& raisedRows, AssignmentResult& result) {
+    int n = costs.size();
+    if ((int)p.size() != n + 1 || (int)result.rowToCol.size() != n) {
+        solve(costs, result);
+        return;
+    }
+
+    // Only the raised edges lose tightness; free their columns and re-augment those rows
+    for (int row : raisedRows) {
+        int col = result.rowToCol[row];
+        if (col >= 0 && p[col + 1] == row + 1) p[col + 1] = 0;
+    }
+    for (int row : raisedRows) {
+        augment(costs, row + 1);
+    }
+    finish(costs, result);
+}
+
+// Grow the matching by one row along a shortest augmenting path (Dijkstra on reduced costs)
+void HungarianBackend::augment(const CostRows& costs, int row) {
+    const int n = costs.size();
+    const double inf = std::numeric_limits<double>::infinity();
+    minv.assign(n + 1, inf);
+    used.assign(n + 1, 0);
+
+    p[0] = row;
+    int j0 = 0;
+    do {
+        used[j0] = 1;
+        int i0 = p[j0];
+        int j1 = 0;
+        double delta = inf;
+        const double* r = costs.row(i0 - 1, scratch.data());
+        double ui = u[i0];
+        for (int j = 1; j <= n; j++) {
+            if (used[j]) continue;
+            double cur = r[j - 1] - ui - v[j];
+            if (cur < minv[j]) {
+                minv[j] = cur;
+                way[j] = j0;
+            }
+            if (minv[j] < delta) {
+                delta = minv[j];
+                j1 = j;
+            }
+        }
+        for (int j = 0; j <= n; j++) {
+            if (used[j]) {
+                u[p[j]] += delta;
+                v[j] -= delta;
+            } else {
+                minv[j] -= delta;
+            }
+        }
+        j0 = j1;
+    } while (p[j0] != 0);
+
+    // Flip the path
+    do {
+        int j1 = way[j0];
+        p[j0] = p[j1];
+        j0 = j1;
+    } while (j0 != 0);
+}
+
+void HungarianBackend::finish(const CostRows& costs, AssignmentResult& result) {
+    int n = costs.size();
+    result.rowToCol.assign(n, -1);
+    result.colToRow.assign(n, -1);
+    result.u.assign(u.begin() + 1, u.end());
+    result.v.assign(v.begin() + 1, v.end());
+    for (int j = 1; j <= n; j++) {
+        if (p[j] != 0) {
+            result.rowToCol[p[j] - 1] = j - 1;
+            result.colToRow[j - 1] = p[j] - 1;
+        }
+    }
+
+    // Tight duals: the matching cost equals the dual objective, no second pass over the costs
+    double cost = 0.0;
+    for (int i = 0; i < n; i++) cost += result.u[i] + result.v[i];
+    result.cost = cost;
+}
+
+#if TSP_WITH_MUNKRES
+void MunkresBackend::solve(const CostRows& costs, AssignmentResult& result) {
+    int n = costs.size();
+    if (matrix.rows() != (size_t)n || matrix.columns() != (size_t)n) {
+        matrix.resize(n, n, 0.0);
+    }
+    scratch.resize(n);
+    for (int i = 0; i < n; i++) {
+        const double* r = costs.row(i, scratch.data());
+        for (int j = 0; j < n; j++) {
+            matrix(i, j) = r[j];
+        }
+    }
+
+    munkres.solve(matrix);
+
+    // munkres-cpp marks assigned cells with 0 and every other cell with -1
+    result.rowToCol.assign(n, -1);
+    result.colToRow.assign(n, -1);
+    result.u.clear();
+    result.v.clear();
+    result.cost = 0.0;
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            if (matrix(i, j) == 0) {
+                result.rowToCol[i] = j;
+                result.colToRow[j] = i;
+                break;
+            }
+        }
+        if (result.rowToCol[i] >= 0) {
+            result.cost += costs.row(i, scratch.data())[result.rowToCol[i]];
+        }
+    }
+}
+#endif
+
+std::size_t HungarianBackend::bytes() const {
+    return (u.capacity() + v.capacity() + minv.capacity() + scratch.capacity()) * sizeof(double) +
+           (p.capacity() + way.capacity()) * sizeof(int) + used.capacity();
+}
+
+#if TSP_WITH_MUNKRES
+std::size_t MunkresBackend::bytes() const {
+    return matrix.rows() * matrix.columns() * sizeof(double) + scratch.capacity() * sizeof(double);
+}
+#endif
@@ -0,0 +1,94 @@
+#ifndef ASSIGNMENTBACKEND_HPP
+#define ASSIGNMENTBACKEND_HPP
+
+// munkres-cpp is optional; builds without it (TSP_WITH_MUNKRES=0) only have
+// the built-in Hungarian backend
+#ifndef TSP_WITH_MUNKRES
+#define TSP_WITH_MUNKRES 1
+#endif
+
+#if TSP_WITH_MUNKRES
+#include "munkres-cpp/src/matrix.h"
+#include "munkres-cpp/src/munkres.h"
+#endif
+#include <vector>
+#include <cstddef>
+
+// Row-wise read access to an n x n cost matrix. Backends never mutate costs.
+class CostRows {
+public:
+    virtual ~CostRows() {}
+    virtual int size() const = 0;
+    // Return row i; implementations may fill scratch (size() entries) and return it
+    virtual const double* row(int i, double* scratch) const = 0;
+};
+
+// Result of one assignment solve
+struct AssignmentResult {
+    std::vector<int> rowToCol;
+    std::vector<int> colToRow;
+    std::vector<double> u;  // Row potentials (empty if the backend has no duals)
+    std::vector<double> v;  // Column potentials; reduced cost is c(i,j) - u[i] - v[j] >= 0
+    double cost;
+
+    AssignmentResult() : cost(0.0) {}
+    bool hasDuals() const { return !u.empty(); }
+};
+
+class AssignmentBackend {
+public:
+    virtual ~AssignmentBackend() {}
+    virtual const char* name() const = 0;
+
+    // Bytes held in reusable buffers
+    virtual std::size_t bytes() const = 0;
+
+    // Solve from scratch
+    virtual void solve(const CostRows& costs, AssignmentResult& result) = 0;
+
+    // Re-solve after the costs of some currently assigned edges went up.
+    // Backends without warm start simply solve again.
+    virtual void resolve(const CostRows& costs, const std::vector<int>& raisedRows, AssignmentResult& result) {
+        (void)raisedRows;
+        solve(costs, result);
+    }
+};
+
+// Shortest augmenting path Hungarian algorithm with dual potentials, O(n^3).
+// Raising assigned costs keeps the duals feasible, so resolve() only has to
+// re-augment the rows that lost their column.
+class HungarianBackend : public AssignmentBackend {
+public:
+    const char* name() const override { return "hungarian"; }
+    std::size_t bytes() const override;
+    void solve(const CostRows& costs, AssignmentResult& result) override;
+    void resolve(const CostRows& costs, const std::vector<int>& raisedRows, AssignmentResult& result) override;
+
+private:
+    void augment(const CostRows& costs, int row);
+    void finish(const CostRows& costs, AssignmentResult& result);
+
+    // Reused between calls (1-based as in the classic formulation, index 0 is the virtual root)
+    std::vector<double> u, v, minv;
+    std::vector<int> p, way;
+    std::vector<char> used;
+    std::vector<double> scratch;
+};
+
+#if TSP_WITH_MUNKRES
+// munkres-cpp wrapper. The library only reports a 0 / -1 mask, so the permutation
+// is recovered from it here and no duals are available.
+class MunkresBackend : public AssignmentBackend {
+public:
+    const char* name() const override { return "munkres"; }
+    std::size_t bytes() const override;
+    void solve(const CostRows& costs, AssignmentResult& result) override;
+
+private:
+    Matrix<double> matrix;
+    Munkres<double> munkres;
+    std::vector<double> scratch;
+};
+#endif
+
+#endif // ASSIGNMENTBACKEND_HPP
@@ -0,0 +1,399 @@
+// Solver benchmark suite: times each phase of the pipeline on seeded synthetic
+// instances and reports the results as JSON, optionally against a baseline.
+//
+//   Benchmark [--out results.json] [--baseline baseline.json] [--threshold 0.10]
+//             [--sizes 10,100,1000,5000,20000] [--reps 15] [--seed 42]
+//             [--max-matrix 10000] [--max-assign 2000] [--max-solve 500]
+//             [--max-layout-solve 1000]
+//
+// Exits with status 2 if any benchmark's median is slower than the baseline by
+// more than the threshold, and 1 if the baseline cannot be read or parsed.
+// Cases the baseline has no entry for are listed on stderr.
+#include "TSPAlgorithm.hpp"
+#include "SolverWorkspace.hpp"
+#include "SolverPhases.hpp"
+#include "AssignmentBackend.hpp"
+#include "Logger.hpp"
+#include "json.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+using json = nlohmann::json;
+
+namespace {
+
+struct BenchConfig {
+    std::vector<int> sizes{10, 100, 1000, 5000, 20000};
+    int reps = 15;
+    unsigned seed = 42;
+    int maxMatrix = 10000;   // 8 * n^2 / 2 bytes: 400 MB at 10k
+    int maxAssign = 2000;    // O(n^3)
+    int maxSolve = 500;      // O(n^3) per patching iteration
+    int maxLayoutSolve = 1000;  // Dense vs packed solves; only worth it where rows miss the cache
+    double threshold = 0.10;
+    std::string outFile;
+    std::string baselineFile;
+};
+
+// Peak resident set size of the process so far, in KB
+long peakRssKb() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return static_cast<long>(counters.PeakWorkingSetSize / 1024);
+    }
+    return 0;
+#else
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024;  // Bytes on macOS
+#else
+    return usage.ru_maxrss;
+#endif
+#endif
+}
+
+// Instance generators; all coordinates lie in [0, 1000)
+void uniformInstance(int n, unsigned seed, CityStore& cities) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> coord(0.0f, 1000.0f);
+    cities.clear();
+    cities.reserve(n, 0);
+    for (int i = 0; i < n; i++) {
+        float x = coord(rng), y = coord(rng);
+        cities.add(x, y, x, y, "");
+    }
+}
+
+void clusteredInstance(int n, unsigned seed, CityStore& cities) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> coord(100.0f, 900.0f);
+    std::normal_distribution<float> spread(0.0f, 25.0f);
+    int clusters = std::max(1, static_cast<int>(std::sqrt(static_cast<double>(n)) / 2));
+    std::vector<std::pair<float, float>> centres(clusters);
+    for (auto& c : centres) c = {coord(rng), coord(rng)};
+
+    cities.clear();
+    cities.reserve(n, 0);
+    for (int i = 0; i < n; i++) {
+        const auto& c = centres[rng() % clusters];
+        float x = std::clamp(c.first + spread(rng), 0.0f, 999.0f);
+        float y = std::clamp(c.second + spread(rng), 0.0f, 999.0f);
+        cities.add(x, y, x, y, "");
+    }
+}
+
+// Grid points have many equal distances, the worst case for assignment ties
+void gridInstance(int n, unsigned, CityStore& cities) {
+    int side = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(n))));
+    float step = 1000.0f / side;
+    cities.clear();
+    cities.reserve(n, 0);
+    for (int i = 0; i < n; i++) {
+        float x = (i % side) * step, y = (i / side) * step;
+        cities.add(x, y, x, y, "");
+    }
+}
+
+struct Distribution {
+    const char* name;
+    void (*generate)(int, unsigned, CityStore&);
+};
+
+const Distribution DISTRIBUTIONS[] = {
+    {"uniform", uniformInstance},
+    {"clustered", clusteredInstance},
+    {"grid", gridInstance},
+};
+
+// Distance rows straight from the packed matrix (the diagonal is already INF)
+class MatrixRows : public CostRows {
+public:
+    explicit MatrixRows(const SymmetricMatrix<double>& distances) : distances(distances) {}
+    int size() const override { return distances.rows(); }
+    const double* row(int i, double* scratch) const override {
+        distances.copyRow(i, scratch);
+        return scratch;
+    }
+private:
+    const SymmetricMatrix<double>& distances;
+};
+
+double percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0.0;
+    double rank = p * (sorted.size() - 1);
+    size_t lo = static_cast<size_t>(rank);
+    size_t hi = std::min(lo + 1, sorted.size() - 1);
+    return sorted[lo] + (sorted[hi] - sorted[lo]) * (rank - lo);
+}
+
+// Run body() reps times (after one warm-up) and summarise the wall-clock times.
+// setup() runs before every repetition and is not timed. The process peak RSS
+// only ever grows, so each case reports how far it raised the peak: 0 means it
+// stayed below an earlier case's, not that it used no memory.
+template<class Setup, class Body>
+json measure(const std::string& name, const char* distribution, int n, int reps,
+             double itemsPerRun, const char* unit, Setup setup, Body body) {
+    long peakBefore = peakRssKb();
+    setup();
+    body();
+
+    std::vector<double> ms;
+    ms.reserve(reps);
+    for (int r = 0; r < reps; r++) {
+        setup();
+        auto start = std::chrono::steady_clock::now();
+        body();
+        ms.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+    std::sort(ms.begin(), ms.end());
+    double median = percentile(ms, 0.5);
+    double mean = std::accumulate(ms.begin(), ms.end(), 0.0) / ms.size();
+
+    json result = {
+        {"name", name},
+        {"distribution", distribution},
+        {"cities", n},
+        {"reps", reps},
+        {"min_ms", ms.front()},
+        {"median_ms", median},
+        {"mean_ms", mean},
+        {"p90_ms", percentile(ms, 0.90)},
+        {"p99_ms", percentile(ms, 0.99)},
+        {"max_ms", ms.back()},
+        {"throughput", median > 0.0 ? itemsPerRun / (median / 1000.0) : 0.0},
+        {"throughput_unit", unit},
+        {"peak_rss_growth_kb", peakRssKb() - peakBefore}
+    };
+    std::cerr << name << " " << distribution << " n=" << n << ": median " << median << " ms" << std::endl;
+    return result;
+}
+
+// Fewer repetitions for the expensive sizes so a full run stays in minutes
+int repsFor(const BenchConfig& config, double cost) {
+    if (cost > 1e9) return std::max(3, config.reps / 5);
+    if (cost > 1e7) return std::max(5, config.reps / 2);
+    return config.reps;
+}
+
+std::string resultKey(const json& r) {
+    return r.at("name").get<std::string>() + "/" + r.at("distribution").get<std::string>() + "/" +
+           std::to_string(r.at("cities").get<int>());
+}
+
+// Annotate results with the baseline median and count the regressions. A
+// baseline that cannot be read or parsed is an error, not an empty baseline:
+// otherwise a typo in the path would pass the gate.
+bool compareWithBaseline(json& results, const std::string& baselineFile, double threshold, int& regressions) {
+    std::ifstream file(baselineFile);
+    if (!file.is_open()) {
+        std::cerr << "ERROR: could not open baseline " << baselineFile << std::endl;
+        return false;
+    }
+
+    std::vector<std::pair<std::string, double>> medians;
+    try {
+        json baseline = json::parse(file);
+        for (const auto& r : baseline.at("results")) {
+            medians.emplace_back(resultKey(r), r.at("median_ms").get<double>());
+        }
+    } catch (const json::exception& ex) {
+        std::cerr << "ERROR: baseline " << baselineFile << " is not a benchmark report: " << ex.what() << std::endl;
+        return false;
+    }
+
+    regressions = 0;
+    int missing = 0;
+    for (auto& r : results) {
+        std::string key = resultKey(r);
+        auto it = std::find_if(medians.begin(), medians.end(),
+                               [&](const std::pair<std::string, double>& m) { return m.first == key; });
+        if (it == medians.end() || it->second <= 0.0) {
+            std::cerr << "NO BASELINE " << key << std::endl;
+            missing++;
+            continue;
+        }
+
+        double ratio = r["median_ms"].get<double>() / it->second;
+        r["baseline_median_ms"] = it->second;
+        r["ratio"] = ratio;
+        r["regression"] = ratio > 1.0 + threshold;
+        if (ratio > 1.0 + threshold) {
+            std::cerr << "REGRESSION " << key << ": " << ratio << "x baseline" << std::endl;
+            regressions++;
+        }
+    }
+    if (missing > 0) {
+        std::cerr << missing << " of " << results.size() << " cases have no baseline entry and were not compared"
+                  << std::endl;
+    }
+    return true;
+}
+
+std::vector<int> parseSizes(const std::string& list) {
+    std::vector<int> sizes;
+    std::stringstream in(list);
+    std::string item;
+    while (std::getline(in, item, ',')) {
+        if (!item.empty()) sizes.push_back(std::atoi(item.c_str()));
+    }
+    return sizes;
+}
+
+bool parseArgs(int argc, char** argv, BenchConfig& config) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << std::endl;
+            return false;
+        }
+        std::string value = argv[++i];
+        if (arg == "--out") config.outFile = value;
+        else if (arg == "--baseline") config.baselineFile = value;
+        else if (arg == "--threshold") config.threshold = std::atof(value.c_str());
+        else if (arg == "--sizes") config.sizes = parseSizes(value);
+        else if (arg == "--reps") config.reps = std::max(1, std::atoi(value.c_str()));
+        else if (arg == "--seed") config.seed = static_cast<unsigned>(std::strtoul(value.c_str(), nullptr, 10));
+        else if (arg == "--max-matrix") config.maxMatrix = std::atoi(value.c_str());
+        else if (arg == "--max-assign") config.maxAssign = std::atoi(value.c_str());
+        else if (arg == "--max-solve") config.maxSolve = std::atoi(value.c_str());
+        else if (arg == "--max-layout-solve") config.maxLayoutSolve = std::atoi(value.c_str());
+        else {
+            std::cerr << "Unknown option " << arg << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+}
+
+int main(int argc, char** argv) {
+    BenchConfig config;
+    if (!parseArgs(argc, argv, config)) return 1;
+
+    // Keep the logger's background thread out of the timings
+    Log::setLevel(LogLevel::Off);
+
+    SolverWorkspace ws;
+    CityStore cities;
+    json results = json::array();
+
+    for (const Distribution& dist : DISTRIBUTIONS) {
+        for (int n : config.sizes) {
+            if (n < 2) continue;
+            dist.generate(n, config.seed, cities);
+            double n2 = static_cast<double>(n) * n;
+
+            // A random permutation gives findSubtours and calculateTourLength
+            // realistic, size-independent input
+            std::vector<int> perm(n);
+            std::iota(perm.begin(), perm.end(), 0);
+            std::shuffle(perm.begin(), perm.end(), std::mt19937(config.seed));
+            std::vector<std::pair<int, int>> pairs(n);
+            for (int i = 0; i < n; i++) pairs[i] = {i, perm[i]};
+
+            results.push_back(measure("tour_length", dist.name, n, config.reps, n, "edges/s",
+                [] {},
+                [&] {
+                    volatile double length = TSPAlgorithm::calculateTourLength(cities, pairs);
+                    (void)length;
+                }));
+
+            results.push_back(measure("find_subtours", dist.name, n, config.reps, n, "cities/s",
+                [&] { ws.assignmentResult.rowToCol = perm; },
+                [&] { SolverPhases::findSubtours(ws, n); }));
+
+            if (n <= config.maxMatrix) {
+                results.push_back(measure("build_matrix", dist.name, n, repsFor(config, n2), n2 / 2, "entries/s",
+                    [] {},
+                    [&] { SolverPhases::buildDistanceMatrix(cities, ws.distances); }));
+            }
+
+            if (n <= config.maxAssign && n <= config.maxMatrix) {
+                SolverPhases::buildDistanceMatrix(cities, ws.distances);
+                MatrixRows costs(ws.distances);
+                results.push_back(measure("assign_hungarian", dist.name, n, repsFor(config, n2 * n), n, "rows/s",
+                    [] {},
+                    [&] { ws.hungarian.solve(costs, ws.assignmentResult); }));
+            }
+
+            if (n <= config.maxSolve) {
+                results.push_back(measure("solve_with_hungarian", dist.name, n, repsFor(config, n2 * n * 10), n,
+                    "cities/s",
+                    [] {},
+                    [&] {
+                        std::vector<TSPStep> steps = TSPAlgorithm::solveWithHungarian(cities, ws);
+                        (void)steps;
+                    }));
+                results.push_back(measure("solve_tour", dist.name, n, repsFor(config, n2 * n * 10), n,
+                    "cities/s",
+                    [] {},
+                    [&] {
+                        SolveResult result = TSPAlgorithm::solveTour(cities, ws);
+                        (void)result;
+                    }));
+            }
+
+            // The same solve on each in-memory layout, whatever size SolverOptions would pick
+            if (n <= config.maxLayoutSolve && n <= config.maxMatrix) {
+                SolverOptions dense, packed;
+                dense.packedThreshold = 0;
+                packed.packedThreshold = 2;
+                dense.outOfCoreThreshold = packed.outOfCoreThreshold = 0;
+                for (const auto& [name, options] : {std::make_pair("solve_dense", dense),
+                                                    std::make_pair("solve_packed", packed)}) {
+                    results.push_back(measure(name, dist.name, n, repsFor(config, n2 * n * 10), n, "cities/s",
+                        [] {},
+                        [&] {
+                            SolveResult result = TSPAlgorithm::solveTour(cities, ws, options);
+                            (void)result;
+                        }));
+                }
+            }
+
+            // Don't let one size's buffers inflate the next size's footprint
+            ws.release();
+        }
+    }
+
+    // The results are still written when the baseline is unusable, but the run fails
+    int regressions = 0;
+    bool compared = config.baselineFile.empty() ||
+                    compareWithBaseline(results, config.baselineFile, config.threshold, regressions);
+
+    json report = {
+        {"seed", config.seed},
+        {"reps", config.reps},
+        {"threshold", config.threshold},
+        {"peak_rss_kb", peakRssKb()},
+        {"regressions", regressions},
+        {"results", results}
+    };
+
+    if (config.outFile.empty()) {
+        std::cout << report.dump(2) << std::endl;
+    } else {
+        std::ofstream out(config.outFile);
+        out << report.dump(2) << std::endl;
+        std::cerr << "Wrote " << config.outFile << std::endl;
+    }
+    if (!compared) return 1;
+    return regressions > 0 ? 2 : 0;
+}
@@ -0,0 +1,55 @@
+#ifndef CAMERA_HPP
+#define CAMERA_HPP
+
+#include "Quadtree.hpp"
+#include <algorithm>
+
+// 2D pan/zoom view. World coordinates are the pixel positions cities were
+// loaded or clicked at; the camera maps them to window pixels (y down) as
+//   screen = (world - center) * zoom + window / 2
+// The default places world (0, 0) at the top-left of an 800x600 window.
+struct Camera {
+    static constexpr float MIN_ZOOM = 1e-5f;
+    static constexpr float MAX_ZOOM = 1e3f;
+
+    float centerX = 400.0f;
+    float centerY = 300.0f;
+    float zoom = 1.0f;  // Window pixels per world unit
+
+    float toScreenX(float worldX, int winWidth) const { return (worldX - centerX) * zoom + winWidth * 0.5f; }
+    float toScreenY(float worldY, int winHeight) const { return (worldY - centerY) * zoom + winHeight * 0.5f; }
+    float toWorldX(float screenX, int winWidth) const { return (screenX - winWidth * 0.5f) / zoom + centerX; }
+    float toWorldY(float screenY, int winHeight) const { return (screenY - winHeight * 0.5f) / zoom + centerY; }
+
+    // Move the view by a drag of (dx, dy) window pixels
+    void pan(float dx, float dy) {
+        centerX -= dx / zoom;
+        centerY -= dy / zoom;
+    }
+
+    // Zoom by factor, keeping the world point under (screenX, screenY) in place
+    void zoomAt(float factor, float screenX, float screenY, int winWidth, int winHeight) {
+        float worldX = toWorldX(screenX, winWidth);
+        float worldY = toWorldY(screenY, winHeight);
+        zoom = std::clamp(zoom * factor, MIN_ZOOM, MAX_ZOOM);
+        centerX = worldX - (screenX - winWidth * 0.5f) / zoom;
+        centerY = worldY - (screenY - winHeight * 0.5f) / zoom;
+    }
+
+    // Show all of box with a small margin
+    void fit(const Box& box, int winWidth, int winHeight) {
+        float w = std::max(box.maxX - box.minX, 1.0f);
+        float h = std::max(box.maxY - box.minY, 1.0f);
+        zoom = std::clamp(0.9f * std::min(winWidth / w, winHeight / h), MIN_ZOOM, MAX_ZOOM);
+        centerX = 0.5f * (box.minX + box.maxX);
+        centerY = 0.5f * (box.minY + box.maxY);
+    }
+
+    // World area covered by the window, grown by marginPixels on every side
+    Box visibleArea(int winWidth, int winHeight, float marginPixels = 0.0f) const {
+        return {toWorldX(-marginPixels, winWidth), toWorldY(-marginPixels, winHeight),
+                toWorldX(winWidth + marginPixels, winWidth), toWorldY(winHeight + marginPixels, winHeight)};
+    }
+};
+
+#endif // CAMERA_HPP
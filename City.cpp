@@ -4,6 +4,9 @@
 #include <fstream>
 #include <algorithm>
 #include <iostream>
+#include <charconv>
+#include <cstring>
+#include <thread>
 #include "json.hpp"
 using json = nlohmann::json;
 
@@ -33,10 +36,86 @@ void loadCitiesFromJsonFile(const std::string& filename, std::vector<City>& citi
     if (!f.is_open()) { std::cerr << "Failed to open JSON file: " << filename << std::endl; return; }
     try {
         json data; f >> data;
+        // A bare city array, or {"cities": [...]} as the visualiser also accepts
+        const json& list = (data.is_object() && data.contains("cities")) ? data["cities"] : data;
         std::vector<std::pair<float, float>> vec;
-        for (const auto& item : data) vec.emplace_back(item["x"].get<float>(), item["y"].get<float>());
+        for (const auto& item : list) vec.emplace_back(item["x"].get<float>(), item["y"].get<float>());
         normalizeCitiesFromRaw(vec, cities);
     } catch (std::exception& ex) {
         std::cerr << "Error parsing JSON: " << ex.what() << std::endl;
     }
 }
+
+// Parse one "x<sep>y" line; separators may be commas, semicolons, spaces or tabs.
+// Extra trailing columns are ignored; headers and '#' comments simply fail to parse.
+static bool parseXYLine(const char* p, const char* end, std::pair<float, float>& out) {
+    auto skipSeparators = [&](const char* q) {
+        while (q < end && (*q == ' ' || *q == '\t' || *q == ',' || *q == ';' || *q == '\r')) q++;
+        return q;
+    };
+    p = skipSeparators(p);
+    auto rx = std::from_chars(p, end, out.first);
+    if (rx.ec != std::errc()) return false;
+    p = skipSeparators(rx.ptr);
+    auto ry = std::from_chars(p, end, out.second);
+    return ry.ec == std::errc();
+}
+
+bool parseXYFile(const std::string& filename, std::vector<std::pair<float, float>>& raw, unsigned threadCount) {
+    std::ifstream f(filename, std::ios::binary | std::ios::ate);
+    if (!f.is_open()) { std::cerr << "Failed to open XY file: " << filename << std::endl; return false; }
+    std::streamsize size = f.tellg();
+    f.seekg(0);
+    std::vector<char> buffer(static_cast<size_t>(size));
+    if (size > 0 && !f.read(buffer.data(), size)) { std::cerr << "Failed to read XY file: " << filename << std::endl; return false; }
+    const char* data = buffer.data();
+    const char* dataEnd = data + buffer.size();
+
+    // Split into newline-aligned chunks of at least 1 MB each
+    if (threadCount == 0) threadCount = std::max(1u, std::thread::hardware_concurrency());
+    const size_t minChunk = 1 << 20;
+    size_t chunkCount = std::max<size_t>(1, std::min<size_t>(threadCount, buffer.size() / minChunk));
+    std::vector<const char*> bounds(chunkCount + 1, dataEnd);
+    bounds[0] = data;
+    for (size_t c = 1; c < chunkCount; c++) {
+        const char* p = std::max(bounds[c - 1], data + buffer.size() * c / chunkCount);
+        p = static_cast<const char*>(std::memchr(p, '\n', dataEnd - p));
+        bounds[c] = p ? p + 1 : dataEnd;
+    }
+
+    // Newline counts give each chunk an upper bound, so one allocation holds every slot
+    std::vector<size_t> offsets(chunkCount + 1, 0);
+    std::vector<size_t> parsed(chunkCount, 0);
+    for (size_t c = 0; c < chunkCount; c++) {
+        offsets[c + 1] = offsets[c] + std::count(bounds[c], bounds[c + 1], '\n') + 1;
+    }
+    raw.clear();
+    raw.resize(offsets[chunkCount]);
+
+    auto parseChunk = [&](size_t c) {
+        std::pair<float, float>* outPtr = raw.data() + offsets[c];
+        size_t count = 0;
+        const char* p = bounds[c];
+        const char* chunkEnd = bounds[c + 1];
+        while (p < chunkEnd) {
+            const char* eol = static_cast<const char*>(std::memchr(p, '\n', chunkEnd - p));
+            if (!eol) eol = chunkEnd;
+            if (parseXYLine(p, eol, outPtr[count])) count++;
+            p = eol + 1;
+        }
+        parsed[c] = count;
+    };
+    std::vector<std::thread> workers;
+    for (size_t c = 1; c < chunkCount; c++) workers.emplace_back(parseChunk, c);
+    parseChunk(0);
+    for (auto& t : workers) t.join();
+
+    // Close the gaps left by unparsable lines; shrinking never reallocates
+    size_t total = parsed[0];
+    for (size_t c = 1; c < chunkCount; c++) {
+        std::copy(raw.begin() + offsets[c], raw.begin() + offsets[c] + parsed[c], raw.begin() + total);
+        total += parsed[c];
+    }
+    raw.resize(total);
+    return true;
+}
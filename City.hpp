@@ -8,3 +8,6 @@ struct City {
 };
 void normalizeCitiesFromRaw(std::vector<std::pair<float, float>>& raw, std::vector<City>& cities);
 void loadCitiesFromJsonFile(const std::string& filename, std::vector<City>& cities);
+// Plain "x,y" / "x y" text dumps (one city per line, parsed on all cores);
+// loadCitiesFromXYFile in CityStore.hpp turns them into cities
+bool parseXYFile(const std::string& filename, std::vector<std::pair<float, float>>& raw, unsigned threadCount = 0);
@@ -0,0 +1,282 @@
+#include "CityRenderer.hpp"
+#include <algorithm>
+#include <cstddef>
+
+#ifndef GL_ARRAY_BUFFER
+#define GL_ARRAY_BUFFER 0x8892
+#define GL_ELEMENT_ARRAY_BUFFER 0x8893
+#define GL_STATIC_DRAW 0x88E4
+#define GL_DYNAMIC_DRAW 0x88E8
+#endif
+
+#ifndef APIENTRY
+#define APIENTRY
+#endif
+
+namespace {
+
+// OpenGL 1.5 buffer functions; opengl32.dll only exports 1.1, so they are
+// looked up at run time
+typedef void (APIENTRY *GenBuffersProc)(GLsizei, GLuint*);
+typedef void (APIENTRY *BindBufferProc)(GLenum, GLuint);
+typedef void (APIENTRY *BufferDataProc)(GLenum, std::ptrdiff_t, const void*, GLenum);
+typedef void (APIENTRY *BufferSubDataProc)(GLenum, std::ptrdiff_t, std::ptrdiff_t, const void*);
+
+GenBuffersProc genBuffers = nullptr;
+BindBufferProc bindBuffer = nullptr;
+BufferDataProc bufferData = nullptr;
+BufferSubDataProc bufferSubData = nullptr;
+
+// Same palette as the matrix panel's subtour list
+const unsigned char SUBTOUR_COLORS[][3] = {
+    {0, 255, 0},    // Green
+    {255, 0, 0},    // Red
+    {255, 255, 0},  // Yellow
+    {255, 0, 255},  // Magenta
+    {0, 255, 255},  // Cyan
+};
+
+const float POINT_SIZE = 8.0f;
+
+// The density raster takes over on instances this large once a texel covers
+// less than DENSITY_TEXEL_PIXELS window pixels
+const std::size_t DENSITY_MIN_CITIES = 50000;
+const float DENSITY_TEXEL_PIXELS = 2.0f;
+
+// Final tours at least this long get a simplification pyramid
+const std::size_t PYRAMID_MIN_CITIES = 4096;
+
+}
+
+void CityRenderer::init() {
+    genBuffers = reinterpret_cast<GenBuffersProc>(glutGetProcAddress("glGenBuffers"));
+    bindBuffer = reinterpret_cast<BindBufferProc>(glutGetProcAddress("glBindBuffer"));
+    bufferData = reinterpret_cast<BufferDataProc>(glutGetProcAddress("glBufferData"));
+    bufferSubData = reinterpret_cast<BufferSubDataProc>(glutGetProcAddress("glBufferSubData"));
+    bufferObjects = genBuffers && bindBuffer && bufferData && bufferSubData;
+
+    if (bufferObjects) {
+        GLuint buffers[3];
+        genBuffers(3, buffers);
+        positionBuffer = buffers[0];
+        colorBuffer = buffers[1];
+        indexBuffer = buffers[2];
+    }
+}
+
+void CityRenderer::uploadPositions() {
+    if (!bufferObjects) return;
+    // Room to grow, so clicks can append with glBufferSubData
+    positionCapacity = positions.size() / 2 + positions.size() / 4 + 64;
+    bindBuffer(GL_ARRAY_BUFFER, positionBuffer);
+    bufferData(GL_ARRAY_BUFFER, positionCapacity * 2 * sizeof(float), nullptr, GL_DYNAMIC_DRAW);
+    bufferSubData(GL_ARRAY_BUFFER, 0, positions.size() * sizeof(float), positions.data());
+    bindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void CityRenderer::setCities(const CityStore& cities) {
+    positions.resize(cities.size() * 2);
+    for (std::size_t i = 0; i < cities.size(); i++) {
+        positions[2 * i] = cities.x(i);
+        positions[2 * i + 1] = cities.y(i);
+    }
+    colors.assign(cities.size() * 3, 0);
+    clearStep();
+    uploadPositions();
+    cityTreeStale = true;
+    density.markPointsStale();
+}
+
+void CityRenderer::appendCity(float x, float y) {
+    positions.push_back(x);
+    positions.push_back(y);
+    colors.resize(colors.size() + 3, 0);
+    cityTreeStale = true;
+    density.markPointsStale();
+    pyramid.clear();  // Built from the old positions
+
+    std::size_t count = positions.size() / 2;
+    if (count > positionCapacity) {
+        uploadPositions();
+    } else if (bufferObjects) {
+        bindBuffer(GL_ARRAY_BUFFER, positionBuffer);
+        bufferSubData(GL_ARRAY_BUFFER, (count - 1) * 2 * sizeof(float), 2 * sizeof(float), &positions[2 * (count - 1)]);
+        bindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+}
+
+void CityRenderer::setStep(const TSPStep& step) {
+    indices.clear();
+    for (std::size_t s = 0; s < step.subtours.size(); s++) {
+        const std::vector<int>& subtour = step.subtours[s];
+        const unsigned char* color = SUBTOUR_COLORS[s % 5];
+        for (std::size_t k = 0; k < subtour.size(); k++) {
+            int city = subtour[k];
+            colors[3 * city] = color[0];
+            colors[3 * city + 1] = color[1];
+            colors[3 * city + 2] = color[2];
+            indices.push_back(city);
+            indices.push_back(subtour[(k + 1) % subtour.size()]);
+        }
+    }
+
+    std::vector<Box> edgeBoxes(indices.size() / 2);
+    for (std::size_t e = 0; e < edgeBoxes.size(); e++) {
+        float x0 = positions[2 * indices[2 * e]], y0 = positions[2 * indices[2 * e] + 1];
+        float x1 = positions[2 * indices[2 * e + 1]], y1 = positions[2 * indices[2 * e + 1] + 1];
+        edgeBoxes[e] = {std::min(x0, x1), std::min(y0, y1), std::max(x0, x1), std::max(y0, y1)};
+    }
+    edgeTree.build(std::move(edgeBoxes));
+    cullStale = true;
+    density.markEdgesStale();
+
+    // Built once per solution: stepping back onto the same tour keeps it
+    if (step.isFinalTour && step.subtours.size() == 1 && step.subtours[0].size() >= PYRAMID_MIN_CITIES) {
+        pyramid.build(positions, step.subtours[0]);
+    } else {
+        pyramid.clear();
+    }
+
+    if (bufferObjects) {
+        bindBuffer(GL_ARRAY_BUFFER, colorBuffer);
+        bufferData(GL_ARRAY_BUFFER, colors.size(), colors.data(), GL_STATIC_DRAW);
+        bindBuffer(GL_ARRAY_BUFFER, 0);
+        bindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+        bufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
+        bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    }
+}
+
+void CityRenderer::clearStep() {
+    indices.clear();
+    edgeTree.clear();
+    cullStale = true;
+    density.markEdgesStale();
+    pyramid.clear();
+}
+
+void CityRenderer::rebuildCityTree() {
+    std::vector<Box> points(positions.size() / 2);
+    for (std::size_t i = 0; i < points.size(); i++) {
+        points[i] = {positions[2 * i], positions[2 * i + 1], positions[2 * i], positions[2 * i + 1]};
+    }
+    cityTree.build(std::move(points));
+    cityTreeStale = false;
+    cullStale = true;
+}
+
+const Box& CityRenderer::bounds() {
+    if (cityTreeStale) rebuildCityTree();
+    return cityTree.bounds();
+}
+
+void CityRenderer::cull(const Camera& camera, int winWidth, int winHeight) {
+    if (cityTreeStale) rebuildCityTree();
+
+    // Grown by the point size so cities on the border are not cut in half
+    Box area = camera.visibleArea(winWidth, winHeight, POINT_SIZE);
+    if (!cullStale && area == culledArea) return;
+    culledArea = area;
+    cullStale = false;
+
+    visibleCityIds.clear();
+    cityTree.query(area, visibleCityIds);
+
+    // Coarsest tour level that is off by less than a pixel (the level only
+    // depends on the zoom, which the area comparison above already covers)
+    visibleEdgeIndices.clear();
+    drawnLevel = pyramid.empty() ? 0 : pyramid.pick(1.0f / camera.zoom);
+    if (drawnLevel > 0) {
+        pyramid.query(drawnLevel, positions, area, visibleEdgeIndices);
+        return;
+    }
+    edgeIds.clear();
+    edgeTree.query(area, edgeIds);
+    for (std::uint32_t e : edgeIds) {
+        visibleEdgeIndices.push_back(indices[2 * e]);
+        visibleEdgeIndices.push_back(indices[2 * e + 1]);
+    }
+}
+
+bool CityRenderer::usesDensity(const Camera& camera) {
+    if (positions.size() / 2 < DENSITY_MIN_CITIES) return false;
+    const Box& box = bounds();
+    float texel = std::max(box.maxX - box.minX, box.maxY - box.minY) / DensityRaster::SIZE;
+    return texel * camera.zoom < DENSITY_TEXEL_PIXELS;
+}
+
+void CityRenderer::drawDensity(const Camera& camera, int winWidth, int winHeight) {
+    density.update(positions, bounds(), indices);
+    pushCamera(camera, winWidth, winHeight);
+    density.draw();
+    glPopMatrix();
+}
+
+// Vertices are in world coordinates; the camera takes them to window pixels
+// (y down), which are then mapped onto the [-1, 1] projection
+void CityRenderer::pushCamera(const Camera& camera, int winWidth, int winHeight) const {
+    glMatrixMode(GL_MODELVIEW);
+    glPushMatrix();
+    glTranslatef(-1.0f, 1.0f, 0.0f);
+    glScalef(2.0f / winWidth, -2.0f / winHeight, 1.0f);
+    glTranslatef(winWidth * 0.5f, winHeight * 0.5f, 0.0f);
+    glScalef(camera.zoom, camera.zoom, 1.0f);
+    glTranslatef(-camera.centerX, -camera.centerY, 0.0f);
+}
+
+void CityRenderer::beginWorldSpace(const Camera& camera, int winWidth, int winHeight) const {
+    pushCamera(camera, winWidth, winHeight);
+
+    glEnableClientState(GL_VERTEX_ARRAY);
+    if (bufferObjects) {
+        bindBuffer(GL_ARRAY_BUFFER, positionBuffer);
+        glVertexPointer(2, GL_FLOAT, 0, nullptr);
+    } else {
+        glVertexPointer(2, GL_FLOAT, 0, positions.data());
+    }
+}
+
+void CityRenderer::endWorldSpace() const {
+    if (bufferObjects) bindBuffer(GL_ARRAY_BUFFER, 0);
+    glDisableClientState(GL_VERTEX_ARRAY);
+    glPopMatrix();
+}
+
+void CityRenderer::drawCities(const Camera& camera, int winWidth, int winHeight) const {
+    if (visibleCityIds.empty()) return;
+    beginWorldSpace(camera, winWidth, winHeight);
+    glColor3f(0.0f, 0.0f, 1.0f);
+    glPointSize(POINT_SIZE);
+    if (visibleCityIds.size() == positions.size() / 2) {
+        glDrawArrays(GL_POINTS, 0, static_cast<GLsizei>(visibleCityIds.size()));
+    } else {
+        glDrawElements(GL_POINTS, static_cast<GLsizei>(visibleCityIds.size()), GL_UNSIGNED_INT, visibleCityIds.data());
+    }
+    endWorldSpace();
+}
+
+void CityRenderer::drawEdges(const Camera& camera, int winWidth, int winHeight, float lineWidth) const {
+    if (visibleEdgeIndices.empty()) return;
+    beginWorldSpace(camera, winWidth, winHeight);
+    glLineWidth(lineWidth);
+
+    // The whole step comes from the index buffer; a partial view from the culled list
+    bool everything = drawnLevel == 0 && visibleEdgeIndices.size() == indices.size();
+    glEnableClientState(GL_COLOR_ARRAY);
+    if (bufferObjects) {
+        bindBuffer(GL_ARRAY_BUFFER, colorBuffer);
+        glColorPointer(3, GL_UNSIGNED_BYTE, 0, nullptr);
+    } else {
+        glColorPointer(3, GL_UNSIGNED_BYTE, 0, colors.data());
+    }
+    if (everything && bufferObjects) {
+        bindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+        glDrawElements(GL_LINES, static_cast<GLsizei>(indices.size()), GL_UNSIGNED_INT, nullptr);
+        bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    } else {
+        const std::vector<GLuint>& edges = everything ? indices : visibleEdgeIndices;
+        glDrawElements(GL_LINES, static_cast<GLsizei>(edges.size()), GL_UNSIGNED_INT, edges.data());
+    }
+    glDisableClientState(GL_COLOR_ARRAY);
+    endWorldSpace();
+}
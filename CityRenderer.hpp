@@ -0,0 +1,88 @@
+#ifndef CITYRENDERER_HPP
+#define CITYRENDERER_HPP
+
+#include "CityStore.hpp"
+#include "TSPAlgorithm.hpp"
+#include "Camera.hpp"
+#include "Quadtree.hpp"
+#include "DensityRaster.hpp"
+#include "TourPyramid.hpp"
+#include <GL/freeglut.h>
+#include <vector>
+
+// Retained-mode drawing of the cities and the current step's edges.
+// City positions live in one vertex buffer (in window pixels, so a resize
+// only changes the projection); each step uploads an index buffer of its
+// edges plus a per-city colour buffer holding the city's subtour colour.
+// Without OpenGL 1.5 buffer objects the same arrays are drawn as client-side
+// vertex arrays instead.
+// Cities and edges are indexed by quadtrees; cull() collects the ones inside
+// the camera's view, and only those are submitted while the view does not
+// cover everything. Zoomed out on a large instance the DensityRaster replaces
+// both. A large final tour is drawn from a simplification level of a
+// TourPyramid, picked so its error stays under a pixel.
+class CityRenderer {
+public:
+    // Load the buffer-object entry points; needs a current GL context
+    void init();
+
+    // Replace all cities (full upload)
+    void setCities(const CityStore& cities);
+
+    // Append one city; goes into the buffer's spare capacity when there is some
+    void appendCity(float x, float y);
+
+    // Upload the edges and subtour colours of a step, or drop them
+    void setStep(const TSPStep& step);
+    void clearStep();
+
+    // Find the cities and edges inside the view; cheap when nothing changed
+    void cull(const Camera& camera, int winWidth, int winHeight);
+    const std::vector<std::uint32_t>& visibleCities() const { return visibleCityIds; }
+
+    void drawCities(const Camera& camera, int winWidth, int winHeight) const;
+    void drawEdges(const Camera& camera, int winWidth, int winHeight, float lineWidth) const;
+
+    // True when the view is zoomed out far enough on enough cities that the
+    // density raster is drawn instead of cities and edges
+    bool usesDensity(const Camera& camera);
+    void drawDensity(const Camera& camera, int winWidth, int winHeight);
+
+    // Extent of all cities in world coordinates
+    const Box& bounds();
+
+    bool usesBufferObjects() const { return bufferObjects; }
+    std::size_t tourLevel() const { return drawnLevel; }
+
+private:
+    void pushCamera(const Camera& camera, int winWidth, int winHeight) const;
+    void beginWorldSpace(const Camera& camera, int winWidth, int winHeight) const;
+    void endWorldSpace() const;
+    void uploadPositions();
+    void rebuildCityTree();
+
+    std::vector<float> positions;       // x, y per city
+    std::vector<unsigned char> colors;  // r, g, b per city
+    std::vector<GLuint> indices;        // Pairs of city indices, one pair per edge
+
+    Quadtree cityTree;                  // One point per city
+    Quadtree edgeTree;                  // One bounding box per edge of the step
+    bool cityTreeStale = true;
+    bool cullStale = true;
+    Box culledArea{0.0f, 0.0f, 0.0f, 0.0f};
+    std::vector<std::uint32_t> visibleCityIds;
+    std::vector<GLuint> visibleEdgeIndices;  // Endpoint pairs of the visible edges
+    std::vector<std::uint32_t> edgeIds;      // Query scratch
+
+    DensityRaster density;
+    TourPyramid pyramid;
+    std::size_t drawnLevel = 0;              // Pyramid level of the visible edges (0: full step)
+
+    GLuint positionBuffer = 0;
+    GLuint colorBuffer = 0;
+    GLuint indexBuffer = 0;
+    std::size_t positionCapacity = 0;   // Cities the position buffer has room for
+    bool bufferObjects = false;
+};
+
+#endif // CITYRENDERER_HPP
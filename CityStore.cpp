@@ -0,0 +1,66 @@
+#include "CityStore.hpp"
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+
+void CityStore::assign(const std::vector<City>& cities) {
+    std::size_t nameBytes = 0;
+    for (const auto& c : cities) nameBytes += c.name.size();
+    clear();
+    reserve(cities.size(), nameBytes);
+    for (const auto& c : cities) add(c.x, c.y, c.orig_x, c.orig_y, c.name);
+}
+
+std::vector<City> CityStore::toCities() const {
+    std::vector<City> cities;
+    cities.reserve(size());
+    for (std::size_t i = 0; i < size(); i++) cities.push_back(at(i));
+    return cities;
+}
+
+City CityStore::at(std::size_t i) const {
+    return { xs[i], ys[i], origXs[i], origYs[i], std::string(name(i)) };
+}
+
+void CityStore::reserve(std::size_t count, std::size_t nameBytes) {
+    xs.reserve(count);
+    ys.reserve(count);
+    origXs.reserve(count);
+    origYs.reserve(count);
+    nameOffsets.reserve(count + 1);
+    nameArena.reserve(nameBytes);
+}
+
+void CityStore::clear() {
+    xs.clear();
+    ys.clear();
+    origXs.clear();
+    origYs.clear();
+    nameArena.clear();
+    nameOffsets.assign(1, 0);
+}
+
+void CityStore::add(float x, float y, float origX, float origY, std::string_view name) {
+    if (nameArena.size() + name.size() > std::numeric_limits<std::uint32_t>::max()) {
+        throw std::length_error("CityStore name arena exceeds 4 GiB");
+    }
+    xs.push_back(x);
+    ys.push_back(y);
+    origXs.push_back(origX);
+    origYs.push_back(origY);
+    nameArena.append(name);
+    nameOffsets.push_back(static_cast<std::uint32_t>(nameArena.size()));
+}
+
+void loadCitiesFromXYFile(const std::string& filename, CityStore& cities) {
+    std::vector<std::pair<float, float>> raw;
+    if (!parseXYFile(filename, raw)) return;
+    cities.clear();
+    cities.reserve(raw.size(), raw.size() * 10);
+    std::string name;
+    for (std::size_t i = 0; i < raw.size(); i++) {
+        name = "City" + std::to_string(i);
+        cities.add(raw[i].first, raw[i].second, raw[i].first, raw[i].second, name);
+    }
+    std::cerr << "Loaded " << cities.size() << " cities from " << filename << std::endl;
+}
@@ -0,0 +1,77 @@
+#ifndef CITYSTORE_HPP
+#define CITYSTORE_HPP
+
+#include "City.hpp"
+#include <vector>
+#include <string>
+#include <string_view>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+// Minimal allocator handing out cache-line aligned blocks for the coordinate arrays
+template<class T, std::size_t Alignment = 64>
+struct AlignedAllocator {
+    using value_type = T;
+    template<class U> struct rebind { using other = AlignedAllocator<U, Alignment>; };
+
+    AlignedAllocator() = default;
+    template<class U> AlignedAllocator(const AlignedAllocator<U, Alignment>&) {}
+
+    T* allocate(std::size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+    }
+    void deallocate(T* p, std::size_t) {
+        ::operator delete(p, std::align_val_t(Alignment));
+    }
+    template<class U> bool operator==(const AlignedAllocator<U, Alignment>&) const { return true; }
+    template<class U> bool operator!=(const AlignedAllocator<U, Alignment>&) const { return false; }
+};
+
+// Structure-of-arrays city storage: hot loops only touch the coordinate arrays,
+// names live in one interned string arena addressed by offsets.
+class CityStore {
+public:
+    using FloatArray = std::vector<float, AlignedAllocator<float>>;
+
+    CityStore() = default;
+    explicit CityStore(const std::vector<City>& cities) { assign(cities); }
+
+    // Adapters for the std::vector<City> API
+    void assign(const std::vector<City>& cities);
+    std::vector<City> toCities() const;
+    City at(std::size_t i) const;
+
+    void reserve(std::size_t count, std::size_t nameBytes = 0);
+    void clear();
+    void add(float x, float y, float origX, float origY, std::string_view name);
+
+    std::size_t size() const { return xs.size(); }
+    bool empty() const { return xs.empty(); }
+
+    // Display coordinates
+    float x(std::size_t i) const { return xs[i]; }
+    float y(std::size_t i) const { return ys[i]; }
+    const float* xData() const { return xs.data(); }
+    const float* yData() const { return ys.data(); }
+
+    // Original coordinates (used for all distance computations)
+    float origX(std::size_t i) const { return origXs[i]; }
+    float origY(std::size_t i) const { return origYs[i]; }
+    const float* origXData() const { return origXs.data(); }
+    const float* origYData() const { return origYs.data(); }
+
+    std::string_view name(std::size_t i) const {
+        return std::string_view(nameArena.data() + nameOffsets[i], nameOffsets[i + 1] - nameOffsets[i]);
+    }
+
+private:
+    FloatArray xs, ys;
+    FloatArray origXs, origYs;
+    std::string nameArena;                    // All names back to back
+    std::vector<std::uint32_t> nameOffsets{0};  // size() + 1 entries into nameArena
+};
+
+void loadCitiesFromXYFile(const std::string& filename, CityStore& cities);
+
+#endif // CITYSTORE_HPP
@@ -2,29 +2,65 @@
 #include <iostream>
 #include <fstream>
 #include <cmath>
+#include <memory>
 #include "json.hpp"
-#include "City.hpp"
+#include "CityStore.hpp"
 #include "TSPAlgorithm.hpp"
+#include "StepHistory.hpp"
+#include "SolveRecorder.hpp"
 #include "MatrixPanel.hpp"
+#include "MatrixHeatmap.hpp"
 #include "RenderUtils.hpp"
+#include "CityRenderer.hpp"
+#include "Camera.hpp"
+#include "FrameScheduler.hpp"
+#include "SalesmanPath.hpp"
+#include <algorithm>
+#include <vector>
 
 using json = nlohmann::json;
 
 // Global state
-std::vector<City> cities;
-std::vector<TSPStep> tspSteps;
+CityStore cities;
+StepHistory tspSteps;
+std::unique_ptr<HungarianStepper> stepper;  // Produces further steps lazily while solving
+HistoryRecorder recorder(tspSteps);
 int currentStepIndex = -1;
 bool showMatrix = true;
 
+// GPU copies of the cities and of the step whose edges they hold
+CityRenderer cityRenderer;
+int uploadedStepIndex = -1;  // -1: the edge buffers are stale
+
+// Formatted rows of the current step's panel, rebuilt when the step changes
+MatrixPanel matrixPanel;
+
+// Cost matrix heatmap (H cycles: off, distances, reduced costs)
+MatrixHeatmap heatmap;
+bool showHeatmap = false;
+MatrixHeatmap::View heatmapView = MatrixHeatmap::View::Costs;
+
 // Track current window size
 int winWidth = 800, winHeight = 600;
 
-// Salesman animation
-float salesmanProgress = 0.0f;
-int salesmanCurrentEdge = 0;
+// Pan/zoom view (right-drag, wheel, arrows, +/-, 0 to fit)
+Camera camera;
+bool panning = false;
+int panLastX = 0, panLastY = 0;
+bool firstReshape = true;
+
+// Label level of detail
+const float LABEL_AREA = 600.0f;   // Screen pixels a label needs around its city
+const int LABEL_CELL = 8;          // Occupancy grid cell size in pixels
+const size_t MAX_LABELS = 1500;    // Per frame, whatever the zoom
+std::vector<unsigned char> labelCells;
+
+// Salesman animation: distance travelled along the final tour, at a speed
+// given in mean edge lengths per second
+SalesmanPath salesmanPath;
+double salesmanDistance = 0.0;
 bool salesmanAnimating = false;
-unsigned int lastTime = 0;
-float animationSpeed = 0.005f;  // Default: slow and smooth
+float animationSpeed = 0.3f;  // Default: slow and smooth
 bool fastMode = false;
 
 // Load cities from JSON
@@ -47,25 +83,55 @@ void loadCitiesFromJSON(const std::string& filename) {
     
     int index = 0;
     for (const auto& cityData : cityArray) {
-        City c;
         // Use name if provided, otherwise generate one
-        if (cityData.contains("name")) {
-            c.name = cityData["name"];
-        } else {
-            c.name = "City" + std::to_string(index);
-        }
-        c.orig_x = cityData["x"];
-        c.orig_y = cityData["y"];
-        c.x = c.orig_x;
-        c.y = c.orig_y;
-        cities.push_back(c);
+        std::string name = cityData.contains("name") ? cityData["name"].get<std::string>()
+                                                     : "City" + std::to_string(index);
+        float x = cityData["x"];
+        float y = cityData["y"];
+        cities.add(x, y, x, y, name);
         index++;
     }
     
     std::cout << "Loaded " << cities.size() << " cities from " << filename << std::endl;
 }
 
-// Solve TSP and prepare animation steps
+// True while the solver still has steps to produce
+bool solverRunning() {
+    return stepper && !stepper->done();
+}
+
+// Compute one more solver step into the history
+bool advanceSolver() {
+    if (!solverRunning()) return false;
+    
+    bool produced = stepper->next();
+    if (produced) {
+        recorder.onStep(*stepper);
+        heatmap.record(*stepper);
+    }
+    if (stepper->done()) {
+        std::cout << "Solution complete: " << tspSteps.size() << " steps generated ("
+                  << tspSteps.bytes() / 1024 << " KB history)" << std::endl;
+        std::cout << "Solver metrics: " << stepper->metrics().toJson() << std::endl;
+    }
+    return produced;
+}
+
+// Background work between frames: stay one step ahead of the viewer;
+// returning false hands the idle time back
+bool solverWork() {
+    if (!solverRunning() || static_cast<int>(tspSteps.size()) > currentStepIndex + 1) return false;
+    advanceSolver();
+    FrameScheduler::invalidate();
+    return true;
+}
+
+void setSalesmanAnimating(bool animating) {
+    salesmanAnimating = animating;
+    FrameScheduler::setAnimating(animating);
+}
+
+// Start solving TSP; only the first step is computed up front
 void solveTSP() {
     if (cities.size() < 2) {
         std::cout << "Need at least 2 cities to solve TSP" << std::endl;
@@ -73,14 +139,19 @@ void solveTSP() {
     }
     
     std::cout << "\nSolving TSP..." << std::endl;
-    tspSteps = TSPAlgorithm::solveWithHungarian(cities);
-    currentStepIndex = 0;
-    
-    std::cout << "Solution complete: " << tspSteps.size() << " steps generated" << std::endl;
-    salesmanAnimating = false;
-    salesmanProgress = 0.0f;
-    salesmanCurrentEdge = 0;
-    glutPostRedisplay();
+    stepper = std::make_unique<HungarianStepper>(cities);
+    heatmap.reset(cities);
+    recorder.onStart(*stepper);
+    advanceSolver();
+    currentStepIndex = tspSteps.empty() ? -1 : 0;
+    uploadedStepIndex = -1;
+    matrixPanel.invalidate();
+    FrameScheduler::wakeWork();
+    
+    setSalesmanAnimating(false);
+    salesmanPath.clear();
+    salesmanDistance = 0.0;
+    FrameScheduler::invalidate();
 }
 
 // Draw a pixelated salesman sprite
@@ -187,104 +258,121 @@ void drawSalesman(float x, float y) {
     glEnd();
 }
 
-// Animation timer callback
-void timer(int value) {
-    if (salesmanAnimating && currentStepIndex >= 0 && currentStepIndex < tspSteps.size()) {
-        const TSPStep& step = tspSteps[currentStepIndex];
-        
-        if (step.isFinalTour && !step.subtours.empty()) {
-            salesmanProgress += animationSpeed;  // Variable speed
-            
-            if (salesmanProgress >= 1.0f) {
-                salesmanProgress = 0.0f;
-                salesmanCurrentEdge++;
-                
-                if (salesmanCurrentEdge >= step.subtours[0].size()) {
-                    salesmanCurrentEdge = 0;  // Loop back to start
-                }
+// Move the salesman by the real time since the previous frame
+void advanceSalesman() {
+    if (!salesmanAnimating) return;
+    if (currentStepIndex < 0 || currentStepIndex >= static_cast<int>(tspSteps.size())) {
+        setSalesmanAnimating(false);
+        return;
+    }
+    const TSPStep& step = tspSteps[currentStepIndex];
+    if (!step.isFinalTour || step.subtours.empty()) {
+        setSalesmanAnimating(false);
+        return;
+    }
+    
+    salesmanDistance += animationSpeed * salesmanPath.meanEdge() * FrameScheduler::frameDelta();
+    if (salesmanPath.length() > 0.0) {
+        salesmanDistance = std::fmod(salesmanDistance, salesmanPath.length());  // Loop back to start
+    }
+}
+
+float screenToNormX(float x) { return x / winWidth * 2.0f - 1.0f; }
+float screenToNormY(float y) { return 1.0f - y / winHeight * 2.0f; }
+
+// Labels appear once the zoom gives each city about LABEL_AREA pixels of
+// screen; a coarse occupancy grid then drops any label that would overlap
+// one already placed
+void drawCityLabels() {
+    const Box& box = cityRenderer.bounds();
+    float worldArea = std::max(box.maxX - box.minX, 1.0f) * std::max(box.maxY - box.minY, 1.0f);
+    float labelZoom = std::sqrt(cities.size() * LABEL_AREA / worldArea);
+    if (camera.zoom < labelZoom) return;
+
+    int gridW = winWidth / LABEL_CELL + 1, gridH = winHeight / LABEL_CELL + 1;
+    labelCells.assign(static_cast<size_t>(gridW) * gridH, 0);
+
+    glColor3f(1.0f, 1.0f, 1.0f);
+    size_t placed = 0;
+    for (uint32_t i : cityRenderer.visibleCities()) {
+        if (placed >= MAX_LABELS) break;
+        std::string label = std::to_string(i);
+
+        // Label box in screen pixels (y down): right of and above the city
+        float sx = camera.toScreenX(cities.x(i), winWidth) + 8.0f;
+        float sy = camera.toScreenY(cities.y(i), winHeight) - 8.0f;
+        int x0 = std::max(static_cast<int>(sx) / LABEL_CELL, 0);
+        int x1 = std::min(static_cast<int>(sx + 9.0f * label.size()) / LABEL_CELL, gridW - 1);
+        int y0 = std::max(static_cast<int>(sy - 15.0f) / LABEL_CELL, 0);
+        int y1 = std::min(static_cast<int>(sy) / LABEL_CELL, gridH - 1);
+        if (sx < 0.0f || sy < 0.0f || x0 > x1 || y0 > y1) continue;
+
+        bool free = true;
+        for (int cy = y0; cy <= y1 && free; cy++) {
+            for (int cx = x0; cx <= x1; cx++) {
+                if (labelCells[cy * gridW + cx]) { free = false; break; }
             }
-            
-            glutPostRedisplay();
-            glutTimerFunc(16, timer, 0);  // ~60 FPS
         }
+        if (!free) continue;
+        for (int cy = y0; cy <= y1; cy++) {
+            std::fill(labelCells.begin() + cy * gridW + x0, labelCells.begin() + cy * gridW + x1 + 1, 1);
+        }
+        RenderUtils::drawText(screenToNormX(sx), screenToNormY(sy), label);
+        placed++;
     }
 }
 
 // Rendering
 void display() {
+    FrameScheduler::beginFrame();
+    advanceSalesman();
+    RenderUtils::beginFrame();
     glClear(GL_COLOR_BUFFER_BIT);
     
-    // Draw cities
-    glColor3f(0.0f, 0.0f, 1.0f);
-    glPointSize(8.0f);
-    glBegin(GL_POINTS);
-    for (const auto& city : cities) {
-        float normX = (city.x / (float)winWidth) * 2.0f - 1.0f;
-        float normY = 1.0f - (city.y / (float)winHeight) * 2.0f;
-        glVertex2f(normX, normY);
+    // Edges of the current step are re-uploaded only when the step changes
+    bool haveStep = currentStepIndex >= 0 && currentStepIndex < static_cast<int>(tspSteps.size());
+    if (haveStep && uploadedStepIndex != currentStepIndex) {
+        cityRenderer.setStep(tspSteps[currentStepIndex]);
+        uploadedStepIndex = currentStepIndex;
     }
-    glEnd();
     
-    // Draw city labels
-    glColor3f(1.0f, 1.0f, 1.0f);
-    for (size_t i = 0; i < cities.size(); i++) {
-        float normX = (cities[i].x / (float)winWidth) * 2.0f - 1.0f;
-        float normY = 1.0f - (cities[i].y / (float)winHeight) * 2.0f;
-        RenderUtils::drawText(normX + 0.02f, normY + 0.02f, std::to_string(i).c_str());
+    // Zoomed out on a huge instance the density raster stands in for cities,
+    // labels and edges; otherwise only what the view shows is submitted
+    bool density = cityRenderer.usesDensity(camera);
+    if (density) {
+        cityRenderer.drawDensity(camera, winWidth, winHeight);
+    } else {
+        cityRenderer.cull(camera, winWidth, winHeight);
+        
+        // Draw cities
+        cityRenderer.drawCities(camera, winWidth, winHeight);
+        
+        // Draw city labels
+        drawCityLabels();
     }
     
     // Draw current step's assignment
-    if (currentStepIndex >= 0 && currentStepIndex < tspSteps.size()) {
+    if (haveStep) {
         const TSPStep& step = tspSteps[currentStepIndex];
         
         // Draw edges with different colors for different subtours
-        const float colors[][3] = {
-            {0.0f, 1.0f, 0.0f},  // Green
-            {1.0f, 0.0f, 0.0f},  // Red
-            {1.0f, 1.0f, 0.0f},  // Yellow
-            {1.0f, 0.0f, 1.0f},  // Magenta
-            {0.0f, 1.0f, 1.0f},  // Cyan
-        };
-        
-        for (size_t s = 0; s < step.subtours.size(); s++) {
-            const auto& subtour = step.subtours[s];
-            int colorIdx = s % 5;
-            glColor3fv(colors[colorIdx]);
-            
-            glLineWidth(step.isFinalTour ? 3.0f : 2.0f);
-            glBegin(GL_LINE_LOOP);
-            for (int cityIdx : subtour) {
-                float normX = (cities[cityIdx].x / (float)winWidth) * 2.0f - 1.0f;
-                float normY = 1.0f - (cities[cityIdx].y / (float)winHeight) * 2.0f;
-                glVertex2f(normX, normY);
-            }
-            glEnd();
-        }
+        if (!density) cityRenderer.drawEdges(camera, winWidth, winHeight, step.isFinalTour ? 3.0f : 2.0f);
         
         // Draw animated salesman on final tour
         if (step.isFinalTour && salesmanAnimating && !step.subtours.empty()) {
-            const auto& tour = step.subtours[0];
-            
-            if (tour.size() > 1) {
-                int fromIdx = tour[salesmanCurrentEdge];
-                int toIdx = tour[(salesmanCurrentEdge + 1) % tour.size()];
-                
-                float fromX = (cities[fromIdx].x / (float)winWidth) * 2.0f - 1.0f;
-                float fromY = 1.0f - (cities[fromIdx].y / (float)winHeight) * 2.0f;
-                float toX = (cities[toIdx].x / (float)winWidth) * 2.0f - 1.0f;
-                float toY = 1.0f - (cities[toIdx].y / (float)winHeight) * 2.0f;
-                
-                float salesmanX = fromX + (toX - fromX) * salesmanProgress;
-                float salesmanY = fromY + (toY - fromY) * salesmanProgress;
-                
-                drawSalesman(salesmanX, salesmanY);
+            if (!salesmanPath.empty()) {
+                float worldX = 0.0f, worldY = 0.0f;
+                salesmanPath.locate(cities, salesmanDistance, worldX, worldY);
+                drawSalesman(screenToNormX(camera.toScreenX(worldX, winWidth)),
+                             screenToNormY(camera.toScreenY(worldY, winHeight)));
             }
         }
         
         // Draw info text
         glColor3f(1.0f, 1.0f, 1.0f);
         std::string info = "Step " + std::to_string(currentStepIndex + 1) + "/" + 
-                          std::to_string(tspSteps.size()) + ": " + step.description;
+                          std::to_string(tspSteps.size()) + (solverRunning() ? "+" : "") +
+                          ": " + step.description;
         RenderUtils::drawText(-0.95f, 0.95f, info.c_str());
         
         if (step.isFinalTour) {
@@ -303,28 +391,50 @@ void display() {
         }
     }
     
-    // Draw matrix panel if enabled
-    if (showMatrix && currentStepIndex >= 0 && currentStepIndex < tspSteps.size()) {
-        MatrixPanel::draw(cities, tspSteps[currentStepIndex]);
+    // Cost matrix heatmap of the current step
+    if (showHeatmap && haveStep && heatmap.available()) {
+        RenderUtils::flushText();
+        heatmap.setStep(tspSteps[currentStepIndex], currentStepIndex, heatmapView);
+        heatmap.draw(winWidth, winHeight);
+    }
+    
+    // Draw matrix panel if enabled (its background has to cover the text queued so far)
+    if (showMatrix && haveStep) {
+        RenderUtils::flushText();
+        matrixPanel.setStep(cities, tspSteps[currentStepIndex], currentStepIndex);
+        matrixPanel.draw();
+    }
+    
+    // Per-phase timings of the current (or last) solve
+    if (stepper) {
+        glColor3f(0.6f, 0.8f, 1.0f);
+        RenderUtils::drawText(-0.95f, -0.88f, stepper->metrics().summary().c_str());
     }
     
     // Instructions
     glColor3f(0.7f, 0.7f, 0.7f);
-    RenderUtils::drawText(-0.95f, -0.95f, "N: Next | P: Previous | S: Solve | M: Matrix | A: Animate | F: Fast | Click: Add");
+    RenderUtils::drawText(-0.95f, -0.95f, "N: Next | P: Previous | S: Solve | M: Matrix | H: Heatmap | A: Animate | F: Fast | Click: Add | Right-drag/Wheel: Pan/Zoom | 0: Fit");
     
+    RenderUtils::flushText();
     glutSwapBuffers();
+    FrameScheduler::endFrame();
 }
 
 // Keyboard handler
-void keyboard(unsigned char key, int x, int y) {
+void keyboard(unsigned char key, int /*x*/, int /*y*/) {
     switch (key) {
         case 'n':  // Next step
         case 'N':
+            // Compute the step now if the idle callback has not got to it yet
+            if (currentStepIndex >= 0 && currentStepIndex == static_cast<int>(tspSteps.size()) - 1) {
+                advanceSolver();
+            }
             if (currentStepIndex < static_cast<int>(tspSteps.size()) - 1) {
                 currentStepIndex++;
+                FrameScheduler::wakeWork();
                 std::cout << "Step " << currentStepIndex + 1 << "/" << tspSteps.size() << std::endl;
-                salesmanAnimating = false;
-                glutPostRedisplay();
+                setSalesmanAnimating(false);
+                FrameScheduler::invalidate();
             }
             break;
             
@@ -333,8 +443,8 @@ void keyboard(unsigned char key, int x, int y) {
             if (currentStepIndex > 0) {
                 currentStepIndex--;
                 std::cout << "Step " << currentStepIndex + 1 << "/" << tspSteps.size() << std::endl;
-                salesmanAnimating = false;
-                glutPostRedisplay();
+                setSalesmanAnimating(false);
+                FrameScheduler::invalidate();
             }
             break;
             
@@ -346,23 +456,39 @@ void keyboard(unsigned char key, int x, int y) {
         case 'm':  // Toggle matrix
         case 'M':
             showMatrix = !showMatrix;
-            glutPostRedisplay();
+            FrameScheduler::invalidate();
+            break;
+            
+        case 'h':  // Cycle the heatmap: off, distances, reduced costs
+        case 'H':
+            if (!showHeatmap) {
+                showHeatmap = true;
+                heatmapView = MatrixHeatmap::View::Costs;
+            } else if (heatmapView == MatrixHeatmap::View::Costs && heatmap.hasDuals(currentStepIndex)) {
+                heatmapView = MatrixHeatmap::View::ReducedCosts;
+            } else {
+                showHeatmap = false;
+            }
+            if (showHeatmap && !heatmap.available()) {
+                std::cout << "Heatmap needs a solve of 2 to " << MatrixHeatmap::MAX_CITIES << " cities" << std::endl;
+            }
+            FrameScheduler::invalidate();
             break;
             
         case 'a':  // Animate salesman
         case 'A':
-            if (currentStepIndex >= 0 && currentStepIndex < tspSteps.size()) {
-                if (tspSteps[currentStepIndex].isFinalTour) {
-                    salesmanAnimating = !salesmanAnimating;
+            if (currentStepIndex >= 0 && currentStepIndex < static_cast<int>(tspSteps.size())) {
+                const TSPStep& step = tspSteps[currentStepIndex];
+                if (step.isFinalTour && !step.subtours.empty()) {
+                    setSalesmanAnimating(!salesmanAnimating);
                     if (salesmanAnimating) {
-                        salesmanProgress = 0.0f;
-                        salesmanCurrentEdge = 0;
-                        glutTimerFunc(16, timer, 0);
+                        salesmanPath.build(cities, step.subtours[0]);
+                        salesmanDistance = 0.0;
                         std::cout << "Salesman animation started!" << std::endl;
                     } else {
                         std::cout << "Salesman animation stopped" << std::endl;
                     }
-                    glutPostRedisplay();
+                    FrameScheduler::invalidate();
                 }
             }
             break;
@@ -371,9 +497,23 @@ void keyboard(unsigned char key, int x, int y) {
         case 'F':
             if (salesmanAnimating) {
                 fastMode = !fastMode;
-                animationSpeed = fastMode ? 0.03f : 0.005f;
+                animationSpeed = fastMode ? 1.8f : 0.3f;
                 std::cout << "Animation speed: " << (fastMode ? "FAST" : "SLOW") << std::endl;
-                glutPostRedisplay();
+                FrameScheduler::invalidate();
+            }
+            break;
+            
+        case '+':  // Zoom around the window centre
+        case '=':
+        case '-':
+            camera.zoomAt(key == '-' ? 0.8f : 1.25f, winWidth * 0.5f, winHeight * 0.5f, winWidth, winHeight);
+            FrameScheduler::invalidate();
+            break;
+            
+        case '0':  // Fit all cities
+            if (!cities.empty()) {
+                camera.fit(cityRenderer.bounds(), winWidth, winHeight);
+                FrameScheduler::invalidate();
             }
             break;
             
@@ -387,38 +527,94 @@ void keyboard(unsigned char key, int x, int y) {
 
 // Mouse handler - add cities by clicking
 void mouse(int button, int state, int x, int y) {
+    if (button == GLUT_RIGHT_BUTTON) {
+        panning = state == GLUT_DOWN;
+        panLastX = x;
+        panLastY = y;
+        return;
+    }
     if (button == GLUT_LEFT_BUTTON && state == GLUT_DOWN) {
-        // Store pixel coordinates directly
-        City newCity;
-        newCity.name = "City" + std::to_string(cities.size());
-        newCity.x = x;
-        newCity.y = y;
-        newCity.orig_x = x;
-        newCity.orig_y = y;
-        
-        cities.push_back(newCity);
-        std::cout << "Added " << newCity.name << " at (" << newCity.orig_x 
-                  << ", " << newCity.orig_y << ")" << std::endl;
+        // Store the world position under the cursor
+        float worldX = camera.toWorldX(static_cast<float>(x), winWidth);
+        float worldY = camera.toWorldY(static_cast<float>(y), winHeight);
+        std::string name = "City" + std::to_string(cities.size());
+        cities.add(worldX, worldY, worldX, worldY, name);
+        cityRenderer.appendCity(worldX, worldY);
+        std::cout << "Added " << name << " at (" << worldX 
+                  << ", " << worldY << ")" << std::endl;
         
         // Reset solution
+        stepper.reset();
         tspSteps.clear();
         currentStepIndex = -1;
-        salesmanAnimating = false;
+        uploadedStepIndex = -1;
+        matrixPanel.invalidate();
+        heatmap.clear();
+        cityRenderer.clearStep();
+        setSalesmanAnimating(false);
         
-        glutPostRedisplay();
+        FrameScheduler::invalidate();
     }
 }
 
+// Right-drag pans the view
+void motion(int x, int y) {
+    if (!panning) return;
+    camera.pan(static_cast<float>(x - panLastX), static_cast<float>(y - panLastY));
+    panLastX = x;
+    panLastY = y;
+    FrameScheduler::invalidate();
+}
+
+// The wheel scrolls the matrix panel when over it and zooms around the cursor elsewhere
+void mouseWheel(int /*wheel*/, int direction, int x, int y) {
+    if (showMatrix && matrixPanel.contains(screenToNormX(static_cast<float>(x)), screenToNormY(static_cast<float>(y)))) {
+        matrixPanel.scroll(direction > 0 ? -3 : 3);
+        FrameScheduler::invalidate();
+        return;
+    }
+    camera.zoomAt(direction > 0 ? 1.25f : 0.8f, static_cast<float>(x), static_cast<float>(y), winWidth, winHeight);
+    FrameScheduler::invalidate();
+}
+
+// Arrow keys pan by a tenth of the window; paging keys scroll the matrix panel
+void specialKeys(int key, int /*x*/, int /*y*/) {
+    switch (key) {
+        case GLUT_KEY_PAGE_UP:   matrixPanel.page(-1); break;
+        case GLUT_KEY_PAGE_DOWN: matrixPanel.page(1); break;
+        case GLUT_KEY_HOME:      matrixPanel.scrollToTop(); break;
+        case GLUT_KEY_END:       matrixPanel.scrollToEnd(); break;
+        case GLUT_KEY_LEFT:  camera.pan(winWidth * 0.1f, 0.0f); break;
+        case GLUT_KEY_RIGHT: camera.pan(-winWidth * 0.1f, 0.0f); break;
+        case GLUT_KEY_UP:    camera.pan(0.0f, winHeight * 0.1f); break;
+        case GLUT_KEY_DOWN:  camera.pan(0.0f, -winHeight * 0.1f); break;
+        default: return;
+    }
+    FrameScheduler::invalidate();
+}
+
 // Reshape handler
 void reshape(int w, int h) {
+    // Keep the world point at the top-left corner where it was, as the old
+    // fixed pixel mapping did; on the first call show every city if they
+    // do not fit the window as loaded
+    float left = camera.toWorldX(0.0f, winWidth);
+    float top = camera.toWorldY(0.0f, winHeight);
     winWidth = w;
     winHeight = h;
+    camera.centerX = left + 0.5f * w / camera.zoom;
+    camera.centerY = top + 0.5f * h / camera.zoom;
+    if (firstReshape && !cities.empty()) {
+        const Box& box = cityRenderer.bounds();
+        if (box.minX < 0.0f || box.minY < 0.0f || box.maxX > w || box.maxY > h) camera.fit(box, w, h);
+    }
+    firstReshape = false;
     glViewport(0, 0, w, h);
     glMatrixMode(GL_PROJECTION);
     glLoadIdentity();
     glOrtho(-1.0, 1.0, -1.0, 1.0, -1.0, 1.0);
     glMatrixMode(GL_MODELVIEW);
-    glutPostRedisplay();
+    FrameScheduler::invalidate();
 }
 
 int main(int argc, char** argv) {
@@ -436,19 +632,33 @@ int main(int argc, char** argv) {
     glutDisplayFunc(display);
     glutKeyboardFunc(keyboard);
     glutMouseFunc(mouse);
+    glutMotionFunc(motion);
+    glutMouseWheelFunc(mouseWheel);
+    glutSpecialFunc(specialKeys);
     glutReshapeFunc(reshape);
-    
-    // Load initial cities
-    loadCitiesFromJSON("cities.json");
+    FrameScheduler::setWork(solverWork);
+    FrameScheduler::init();
+    
+    // Load initial cities (optional path argument; non-JSON files are read as x,y text)
+    std::string cityFile = argc > 1 ? argv[1] : "cities.json";
+    if (cityFile.size() >= 5 && cityFile.compare(cityFile.size() - 5, 5, ".json") == 0) {
+        loadCitiesFromJSON(cityFile);
+    } else {
+        loadCitiesFromXYFile(cityFile, cities);
+    }
+    cityRenderer.init();
+    cityRenderer.setCities(cities);
     
     std::cout << "\n=== Interactive TSP Solver ===" << std::endl;
     std::cout << "Controls:" << std::endl;
     std::cout << "  S - Solve TSP using Hungarian Algorithm" << std::endl;
     std::cout << "  N - Next step in animation" << std::endl;
     std::cout << "  P - Previous step" << std::endl;
-    std::cout << "  M - Toggle matrix display" << std::endl;
+    std::cout << "  M - Toggle matrix display (PgUp/PgDn/Home/End or wheel over it to scroll)" << std::endl;
+    std::cout << "  H - Cost heatmap: distances, reduced costs, off" << std::endl;
     std::cout << "  A - Animate traveling salesman (on final tour)" << std::endl;
     std::cout << "  Click - Add new city" << std::endl;
+    std::cout << "  Right-drag/Arrows - Pan, Wheel/+/- - Zoom, 0 - Fit all cities" << std::endl;
     std::cout << "  Q/ESC - Quit" << std::endl;
     
     glutMainLoop();
@@ -0,0 +1,160 @@
+#include "DensityRaster.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    const unsigned MAX_CHUNKS = 8;            // Bounds the per-chunk grids (4 MB each)
+    const std::size_t MIN_CHUNK_ITEMS = 16384;
+    const std::size_t CELLS = static_cast<std::size_t>(DensityRaster::SIZE) * DensityRaster::SIZE;
+
+    // Bin of a grid coordinate, clamped onto the grid
+    inline int binOf(float v) {
+        return std::clamp(static_cast<int>(v), 0, DensityRaster::SIZE - 1);
+    }
+
+    // Nonzero counts start at a visible floor; the rest is log-scaled to the maximum
+    inline float intensity(std::uint32_t count, float logMax) {
+        if (count == 0) return 0.0f;
+        return 0.3f + 0.7f * std::log1p(static_cast<float>(count)) / logMax;
+    }
+}
+
+template<class Body>
+unsigned DensityRaster::parallelChunks(std::size_t count, Body body) {
+    if (!pool) pool = std::make_unique<ThreadPool>();
+    unsigned chunks = static_cast<unsigned>(std::min<std::size_t>({pool->size(), MAX_CHUNKS, count / MIN_CHUNK_ITEMS + 1}));
+    for (unsigned c = 0; c < chunks; c++) {
+        std::size_t begin = count * c / chunks, end = count * (c + 1) / chunks;
+        pool->submit([=, &body] { body(begin, end, c); });
+    }
+    pool->wait();
+    return chunks;
+}
+
+void DensityRaster::update(const std::vector<float>& positions, const Box& bounds, const std::vector<GLuint>& edges) {
+    if (!pointsStale && !edgesStale) return;
+
+    if (pointsStale) {
+        // A square extent keeps texels square
+        float side = std::max({bounds.maxX - bounds.minX, bounds.maxY - bounds.minY, 1.0f});
+        extent = {bounds.minX, bounds.minY, bounds.minX + side, bounds.minY + side};
+        binPoints(positions);
+        edgesStale = true;  // Bins moved with the extent
+    }
+    binEdges(positions, edges);
+    colorize();
+    partials.clear();
+    partials.shrink_to_fit();
+    pointsStale = edgesStale = false;
+
+    if (texture == 0) glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, SIZE, SIZE, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+// Each chunk counts into its own grid; the grids are then summed cell-parallel
+void DensityRaster::binPoints(const std::vector<float>& positions) {
+    const std::size_t count = positions.size() / 2;
+    const float scale = SIZE / (extent.maxX - extent.minX);
+    partials.resize(MAX_CHUNKS);
+
+    unsigned chunks = parallelChunks(count, [&](std::size_t begin, std::size_t end, unsigned chunk) {
+        std::vector<std::uint32_t>& grid = partials[chunk];
+        grid.assign(CELLS, 0);
+        for (std::size_t i = begin; i < end; i++) {
+            int bx = binOf((positions[2 * i] - extent.minX) * scale);
+            int by = binOf((positions[2 * i + 1] - extent.minY) * scale);
+            grid[by * SIZE + bx]++;
+        }
+    });
+
+    pointCounts.resize(CELLS);
+    parallelChunks(CELLS, [&](std::size_t begin, std::size_t end, unsigned) {
+        for (std::size_t cell = begin; cell < end; cell++) {
+            std::uint32_t sum = 0;
+            for (unsigned c = 0; c < chunks; c++) sum += partials[c][cell];
+            pointCounts[cell] = sum;
+        }
+    });
+}
+
+// Edges are walked in steps of at most one texel, counting every texel they cross
+void DensityRaster::binEdges(const std::vector<float>& positions, const std::vector<GLuint>& edges) {
+    edgeCounts.assign(CELLS, 0);
+    const std::size_t count = edges.size() / 2;
+    if (count == 0) return;
+    const float scale = SIZE / (extent.maxX - extent.minX);
+    partials.resize(MAX_CHUNKS);
+
+    unsigned chunks = parallelChunks(count, [&](std::size_t begin, std::size_t end, unsigned chunk) {
+        std::vector<std::uint32_t>& grid = partials[chunk];
+        grid.assign(CELLS, 0);
+        for (std::size_t e = begin; e < end; e++) {
+            float x0 = (positions[2 * edges[2 * e]] - extent.minX) * scale;
+            float y0 = (positions[2 * edges[2 * e] + 1] - extent.minY) * scale;
+            float x1 = (positions[2 * edges[2 * e + 1]] - extent.minX) * scale;
+            float y1 = (positions[2 * edges[2 * e + 1] + 1] - extent.minY) * scale;
+            int steps = static_cast<int>(std::ceil(std::max(std::fabs(x1 - x0), std::fabs(y1 - y0))));
+            float dx = steps > 0 ? (x1 - x0) / steps : 0.0f;
+            float dy = steps > 0 ? (y1 - y0) / steps : 0.0f;
+            for (int s = 0; s <= steps; s++) {
+                grid[binOf(y0 + dy * s) * SIZE + binOf(x0 + dx * s)]++;
+            }
+        }
+    });
+
+    parallelChunks(CELLS, [&](std::size_t begin, std::size_t end, unsigned) {
+        for (std::size_t cell = begin; cell < end; cell++) {
+            std::uint32_t sum = 0;
+            for (unsigned c = 0; c < chunks; c++) sum += partials[c][cell];
+            edgeCounts[cell] = sum;
+        }
+    });
+}
+
+void DensityRaster::colorize() {
+    std::uint32_t maxPoints = *std::max_element(pointCounts.begin(), pointCounts.end());
+    std::uint32_t maxEdges = *std::max_element(edgeCounts.begin(), edgeCounts.end());
+    float logPoints = std::log1p(static_cast<float>(std::max(maxPoints, 1u)));
+    float logEdges = std::log1p(static_cast<float>(std::max(maxEdges, 1u)));
+
+    // Premultiplied alpha: edges green over cities blue
+    pixels.resize(CELLS * 4);
+    parallelChunks(CELLS, [&](std::size_t begin, std::size_t end, unsigned) {
+        for (std::size_t cell = begin; cell < end; cell++) {
+            float p = intensity(pointCounts[cell], logPoints);
+            float e = intensity(edgeCounts[cell], logEdges);
+            unsigned char* pixel = &pixels[cell * 4];
+            pixel[0] = 0;
+            pixel[1] = static_cast<unsigned char>(255.0f * e);
+            pixel[2] = static_cast<unsigned char>(255.0f * p * (1.0f - e));
+            pixel[3] = static_cast<unsigned char>(255.0f * std::max(p, e));
+        }
+    });
+}
+
+void DensityRaster::draw() const {
+    if (texture == 0) return;
+    glEnable(GL_TEXTURE_2D);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_REPLACE);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+
+    glBegin(GL_QUADS);
+    glTexCoord2f(0.0f, 0.0f); glVertex2f(extent.minX, extent.minY);
+    glTexCoord2f(1.0f, 0.0f); glVertex2f(extent.maxX, extent.minY);
+    glTexCoord2f(1.0f, 1.0f); glVertex2f(extent.maxX, extent.maxY);
+    glTexCoord2f(0.0f, 1.0f); glVertex2f(extent.minX, extent.maxY);
+    glEnd();
+
+    glDisable(GL_BLEND);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glDisable(GL_TEXTURE_2D);
+}
@@ -0,0 +1,50 @@
+#ifndef DENSITYRASTER_HPP
+#define DENSITYRASTER_HPP
+
+#include "Quadtree.hpp"
+#include "ThreadPool.hpp"
+#include <GL/freeglut.h>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Zoomed-out stand-in for per-city drawing: cities and step edges are binned
+// on the CPU into a SIZE x SIZE count grid over the city bounds, in parallel,
+// and shown as one texture (blue for cities, green for edges, log-scaled so
+// sparse areas stay visible). The grids are rebuilt only when the cities or
+// the step change, so drawing costs the same for any number of cities.
+class DensityRaster {
+public:
+    static constexpr int SIZE = 1024;
+
+    void markPointsStale() { pointsStale = true; }
+    void markEdgesStale() { edgesStale = true; }
+
+    // Rebuild the stale layers and upload; positions are x, y per city and
+    // edges pairs of city indices. Needs a current GL context.
+    void update(const std::vector<float>& positions, const Box& bounds, const std::vector<GLuint>& edges);
+
+    // Textured quad over the binned area, in world coordinates
+    void draw() const;
+
+private:
+    void binPoints(const std::vector<float>& positions);
+    void binEdges(const std::vector<float>& positions, const std::vector<GLuint>& edges);
+    void colorize();
+
+    // Split [0, count) into one chunk per worker and run body(begin, end, chunk)
+    template<class Body>
+    unsigned parallelChunks(std::size_t count, Body body);
+
+    std::unique_ptr<ThreadPool> pool;
+    std::vector<std::vector<std::uint32_t>> partials;  // Per-chunk grids while binning
+    std::vector<std::uint32_t> pointCounts;
+    std::vector<std::uint32_t> edgeCounts;
+    std::vector<unsigned char> pixels;                 // RGBA
+    Box extent{0.0f, 0.0f, 0.0f, 0.0f};                // Square area the grid covers
+    GLuint texture = 0;
+    bool pointsStale = true;
+    bool edgesStale = true;
+};
+
+#endif // DENSITYRASTER_HPP
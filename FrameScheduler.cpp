@@ -0,0 +1,126 @@
+#include "FrameScheduler.hpp"
+#include <GL/freeglut.h>
+#include <algorithm>
+
+#ifndef APIENTRY
+#define APIENTRY
+#endif
+
+namespace {
+    const int FRAME_MS = 16;          // Timer pacing without vsync (~60 FPS)
+    const double MAX_DELTA = 0.1;     // Longer gaps (a stall, a drag) do not jump the animation
+    const int VSYNC_PROBE_FRAMES = 30;
+    const double VSYNC_MIN_INTERVAL = 0.004;  // Faster than 250 FPS means the swap is not waiting
+
+    typedef int (APIENTRY *SwapIntervalProc)(int);
+
+    bool animationOn = false;
+    bool vsync = false;
+    bool timerArmed = false;
+    bool idleRegistered = false;
+    bool (*backgroundWork)() = nullptr;
+
+    double currentTime = 0.0;
+    double previousTime = 0.0;
+    double delta = 0.0;
+    bool previousWasAnimated = false;
+    int probeFrames = 0;
+    double probeStart = 0.0;
+
+    double now() {
+        return glutGet(GLUT_ELAPSED_TIME) / 1000.0;
+    }
+
+    void onTimer(int) {
+        timerArmed = false;
+        if (animationOn) glutPostRedisplay();
+    }
+
+    // At most one timer is ever pending
+    void armTimer(int delayMs) {
+        if (timerArmed) return;
+        timerArmed = true;
+        glutTimerFunc(static_cast<unsigned>(std::max(delayMs, 0)), onTimer, 0);
+    }
+
+    void onIdle() {
+        if (!backgroundWork || !backgroundWork()) {
+            glutIdleFunc(nullptr);
+            idleRegistered = false;
+        }
+    }
+}
+
+namespace FrameScheduler {
+    void init() {
+        // Whichever swap-control extension the platform has; all take the interval
+        const char* names[] = {"wglSwapIntervalEXT", "glXSwapIntervalMESA", "glXSwapIntervalSGI"};
+        for (const char* name : names) {
+            SwapIntervalProc swapInterval = reinterpret_cast<SwapIntervalProc>(glutGetProcAddress(name));
+            if (swapInterval) {
+                swapInterval(1);
+                vsync = true;  // Confirmed (or dropped) by the frame timing in endFrame()
+                break;
+            }
+        }
+    }
+
+    void invalidate() {
+        glutPostRedisplay();
+    }
+
+    void setAnimating(bool animating) {
+        if (animating == animationOn) return;
+        animationOn = animating;
+        probeFrames = 0;
+        if (animating) glutPostRedisplay();
+    }
+
+    bool animating() {
+        return animationOn;
+    }
+
+    void setWork(bool (*work)()) {
+        backgroundWork = work;
+    }
+
+    void wakeWork() {
+        if (idleRegistered || !backgroundWork) return;
+        idleRegistered = true;
+        glutIdleFunc(onIdle);
+    }
+
+    void beginFrame() {
+        currentTime = now();
+        delta = previousWasAnimated ? std::min(currentTime - previousTime, MAX_DELTA) : 0.0;
+        previousTime = currentTime;
+        previousWasAnimated = animationOn;
+    }
+
+    void endFrame() {
+        if (!animationOn) return;
+
+        if (vsync) {
+            // The swap blocked until the vertical blank, so the next frame can be
+            // posted right away; if frames come back far too fast, the driver
+            // ignored the swap interval and the timer takes over
+            if (probeFrames++ == 0) probeStart = currentTime;
+            if (probeFrames == VSYNC_PROBE_FRAMES && (now() - probeStart) / VSYNC_PROBE_FRAMES < VSYNC_MIN_INTERVAL) {
+                vsync = false;
+            } else {
+                glutPostRedisplay();
+                return;
+            }
+        }
+        int elapsedMs = static_cast<int>((now() - currentTime) * 1000.0);
+        armTimer(FRAME_MS - elapsedMs);
+    }
+
+    double frameTime() {
+        return currentTime;
+    }
+
+    double frameDelta() {
+        return delta;
+    }
+}
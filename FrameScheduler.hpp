@@ -0,0 +1,34 @@
+#ifndef FRAMESCHEDULER_HPP
+#define FRAMESCHEDULER_HPP
+
+// The one place that decides when the window redraws. Nothing is drawn
+// unless something asked for it: input, a resize or a new step request a
+// single frame, animation keeps frames coming until it is switched off, and
+// background work (the solver) runs from the idle callback only while it
+// reports more to do. Animation frames are paced by the buffer swap when
+// vsync could be enabled, otherwise by a single timer chain that is never
+// armed twice.
+namespace FrameScheduler {
+    // Try to turn on vsync; needs a current GL context
+    void init();
+
+    // Draw one more frame
+    void invalidate();
+
+    void setAnimating(bool animating);
+    bool animating();
+
+    // Register the background work; it runs between frames while wakeWork()
+    // has been called and work() keeps returning true
+    void setWork(bool (*work)());
+    void wakeWork();
+
+    // Frame clock: call beginFrame() first thing in display() and
+    // endFrame() after the swap
+    void beginFrame();
+    void endFrame();
+    double frameTime();   // Seconds since start, fixed for the whole frame
+    double frameDelta();  // Seconds since the previous frame (0 after a pause)
+}
+
+#endif // FRAMESCHEDULER_HPP
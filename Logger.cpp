@@ -0,0 +1,206 @@
+#include "Logger.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace {
+
+const size_t RING_SLOTS = 4096;        // Must be a power of two
+const size_t SLOT_TEXT = 480;
+
+struct Slot {
+    std::atomic<size_t> sequence;
+    LogLevel level;
+    LogCategory category;
+    char text[SLOT_TEXT];
+};
+
+LogLevel defaultLevel() {
+    if (const char* env = std::getenv("TSP_LOG_LEVEL")) {
+        for (int l = 0; l <= static_cast<int>(LogLevel::Off); l++) {
+            if (std::strcmp(env, Log::levelName(static_cast<LogLevel>(l))) == 0) return static_cast<LogLevel>(l);
+        }
+    }
+#ifdef NDEBUG
+    return LogLevel::Warn;
+#else
+    return LogLevel::Info;
+#endif
+}
+
+// Bounded multi-producer / single-consumer ring (sequence-numbered slots)
+class AsyncLogger {
+public:
+    AsyncLogger() : head(0), tail(0), droppedCount(0), running(false) {
+        for (size_t i = 0; i < RING_SLOTS; i++) slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    ~AsyncLogger() {
+        if (running.exchange(false)) worker.join();
+    }
+
+    void push(LogLevel level, LogCategory category, const char* format, va_list args) {
+        std::call_once(started, [this] {
+            running = true;
+            worker = std::thread(&AsyncLogger::drainLoop, this);
+        });
+
+        size_t pos = head.load(std::memory_order_relaxed);
+        Slot* slot;
+        for (;;) {
+            slot = &slots[pos & (RING_SLOTS - 1)];
+            size_t seq = slot->sequence.load(std::memory_order_acquire);
+            long long diff = static_cast<long long>(seq) - static_cast<long long>(pos);
+            if (diff == 0) {
+                if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (diff < 0) {
+                droppedCount.fetch_add(1, std::memory_order_relaxed);
+                return;
+            } else {
+                pos = head.load(std::memory_order_relaxed);
+            }
+        }
+
+        slot->level = level;
+        slot->category = category;
+        std::vsnprintf(slot->text, SLOT_TEXT, format, args);
+        slot->sequence.store(pos + 1, std::memory_order_release);
+    }
+
+    void flush() {
+        size_t target = head.load(std::memory_order_acquire);
+        while (running && tail.load(std::memory_order_acquire) < target) {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    }
+
+    unsigned long long dropped() const { return droppedCount.load(std::memory_order_relaxed); }
+
+private:
+    // Copy out as many ready slots as possible, warnings and errors into err;
+    // returns how many were taken
+    size_t drain(std::string& out, std::string& err) {
+        size_t count = 0;
+        size_t pos = tail.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = slots[pos & (RING_SLOTS - 1)];
+            if (slot.sequence.load(std::memory_order_acquire) != pos + 1) break;
+            std::string& target = slot.level >= LogLevel::Warn ? err : out;
+            target += '[';
+            target += Log::levelName(slot.level);
+            target += "][";
+            target += Log::categoryName(slot.category);
+            target += "] ";
+            target += slot.text;
+            target += '\n';
+            slot.sequence.store(pos + RING_SLOTS, std::memory_order_release);
+            pos++;
+            count++;
+        }
+        tail.store(pos, std::memory_order_release);
+        return count;
+    }
+
+    void drainLoop() {
+        std::string buffer, errors;
+        auto idleSleep = std::chrono::microseconds(100);
+        for (;;) {
+            bool stopping = !running.load(std::memory_order_acquire);
+            buffer.clear();
+            errors.clear();
+            size_t taken = drain(buffer, errors);
+            if (taken > 0) {
+                if (!buffer.empty()) {
+                    std::fwrite(buffer.data(), 1, buffer.size(), stdout);
+                    std::fflush(stdout);
+                }
+                if (!errors.empty()) {
+                    std::fwrite(errors.data(), 1, errors.size(), stderr);
+                    std::fflush(stderr);
+                }
+                idleSleep = std::chrono::microseconds(100);
+            } else if (stopping) {
+                break;
+            } else {
+                std::this_thread::sleep_for(idleSleep);
+                if (idleSleep < std::chrono::milliseconds(5)) idleSleep *= 2;
+            }
+        }
+    }
+
+    Slot slots[RING_SLOTS];
+    std::atomic<size_t> head;
+    std::atomic<size_t> tail;
+    std::atomic<unsigned long long> droppedCount;
+    std::atomic<bool> running;
+    std::once_flag started;
+    std::thread worker;
+};
+
+std::atomic<int> currentLevel{static_cast<int>(defaultLevel())};
+
+AsyncLogger& logger() {
+    static AsyncLogger instance;
+    return instance;
+}
+
+}
+
+namespace Log {
+    void setLevel(LogLevel level) {
+        currentLevel.store(static_cast<int>(level), std::memory_order_relaxed);
+    }
+
+    LogLevel level() {
+        return static_cast<LogLevel>(currentLevel.load(std::memory_order_relaxed));
+    }
+
+    bool enabled(LogLevel level) {
+        return level != LogLevel::Off && static_cast<int>(level) >= currentLevel.load(std::memory_order_relaxed);
+    }
+
+    void write(LogLevel level, LogCategory category, const char* format, ...) {
+        va_list args;
+        va_start(args, format);
+        logger().push(level, category, format, args);
+        va_end(args);
+    }
+
+    void flush() {
+        logger().flush();
+    }
+
+    unsigned long long dropped() {
+        return logger().dropped();
+    }
+
+    const char* levelName(LogLevel level) {
+        switch (level) {
+            case LogLevel::Trace: return "trace";
+            case LogLevel::Debug: return "debug";
+            case LogLevel::Info:  return "info";
+            case LogLevel::Warn:  return "warn";
+            case LogLevel::Error: return "error";
+            case LogLevel::Off:   return "off";
+        }
+        return "?";
+    }
+
+    const char* categoryName(LogCategory category) {
+        switch (category) {
+            case LogCategory::Solver:  return "solver";
+            case LogCategory::Matrix:  return "matrix";
+            case LogCategory::Assign:  return "assign";
+            case LogCategory::Extract: return "extract";
+            case LogCategory::Subtour: return "subtour";
+            case LogCategory::Patch:   return "patch";
+        }
+        return "?";
+    }
+}
@@ -0,0 +1,52 @@
+#ifndef LOGGER_HPP
+#define LOGGER_HPP
+
+// Levelled asynchronous logger. Messages are formatted straight into a
+// lock-free ring buffer and written by a background thread, so the solver
+// never blocks on console I/O: trace to info go to stdout, warnings and
+// errors to stderr (where they went before the logger, and out of the way
+// of tools that print results on stdout). When the ring is full, messages
+// are dropped (and counted) rather than stalling the caller.
+//
+// The default level is Warn in release builds (NDEBUG) and Info otherwise;
+// the TSP_LOG_LEVEL environment variable (trace, debug, info, warn, error, off)
+// overrides it at start-up. Levels below TSP_LOG_MIN_LEVEL compile away entirely.
+
+enum class LogLevel { Trace = 0, Debug, Info, Warn, Error, Off };
+
+// Categories are the solver phases
+enum class LogCategory { Solver = 0, Matrix, Assign, Extract, Subtour, Patch };
+
+namespace Log {
+    void setLevel(LogLevel level);
+    LogLevel level();
+    bool enabled(LogLevel level);
+
+    void write(LogLevel level, LogCategory category, const char* format, ...)
+#if defined(__GNUC__)
+        __attribute__((format(printf, 3, 4)))
+#endif
+        ;
+
+    // Block until everything queued so far has been written
+    void flush();
+
+    // Messages lost because the ring buffer was full
+    unsigned long long dropped();
+
+    const char* levelName(LogLevel level);
+    const char* categoryName(LogCategory category);
+}
+
+#ifndef TSP_LOG_MIN_LEVEL
+#define TSP_LOG_MIN_LEVEL 0
+#endif
+
+#define TSP_LOG(level, category, ...)                                              \
+    do {                                                                           \
+        if (static_cast<int>(level) >= TSP_LOG_MIN_LEVEL && Log::enabled(level)) { \
+            Log::write(level, category, __VA_ARGS__);                              \
+        }                                                                          \
+    } while (0)
+
+#endif // LOGGER_HPP
@@ -0,0 +1,132 @@
+#include "MappedMatrix.hpp"
+#include <iostream>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+MappedMatrix::MappedMatrix()
+    : base(nullptr), n(0), mappedBytes(0)
+#ifdef _WIN32
+    , fileHandle(nullptr), mappingHandle(nullptr)
+#else
+    , fd(-1)
+#endif
+{}
+
+MappedMatrix::~MappedMatrix() {
+    close();
+}
+
+bool MappedMatrix::open(const std::string& directory, std::size_t size) {
+    close();
+    if (size == 0) return false;
+    const std::size_t bytes = size * size * sizeof(double);
+
+#ifdef _WIN32
+    // GetTempFileName creates the file under a unique name; reopening it
+    // delete-on-close removes it with the last handle, crash or not
+    char path[MAX_PATH];
+    if (GetTempFileNameA(directory.c_str(), "tsp", 0, path) == 0) {
+        std::cerr << "Failed to create matrix file in: " << directory << std::endl;
+        return false;
+    }
+    HANDLE file = CreateFileA(path, GENERIC_READ | GENERIC_WRITE, 0, nullptr,
+                              CREATE_ALWAYS, FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        std::cerr << "Failed to open matrix file: " << path << std::endl;
+        DeleteFileA(path);
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE,
+                                        static_cast<DWORD>(static_cast<unsigned long long>(bytes) >> 32),
+                                        static_cast<DWORD>(bytes & 0xFFFFFFFFull), nullptr);
+    if (!mapping) {
+        std::cerr << "Failed to map matrix file: " << path << std::endl;
+        CloseHandle(file);
+        return false;
+    }
+    void* view = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, bytes);
+    if (!view) {
+        std::cerr << "Failed to map matrix view: " << path << std::endl;
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+    fileHandle = file;
+    mappingHandle = mapping;
+#else
+    // mkstemp picks a name no other process holds (O_CREAT | O_EXCL); the
+    // name is removed straight away and the space goes with the last fd
+    std::string pattern = directory;
+    if (!pattern.empty() && pattern.back() != '/') pattern += '/';
+    pattern += "tsp_distances_XXXXXX";
+    std::vector<char> path(pattern.begin(), pattern.end());
+    path.push_back('\0');
+    fd = mkstemp(path.data());
+    if (fd < 0) {
+        std::cerr << "Failed to create matrix file in: " << directory << std::endl;
+        return false;
+    }
+    unlink(path.data());
+    if (ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+        std::cerr << "Failed to size matrix file: " << path.data() << std::endl;
+        close();
+        return false;
+    }
+    void* view = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (view == MAP_FAILED) {
+        std::cerr << "Failed to map matrix file: " << path.data() << std::endl;
+        close();
+        return false;
+    }
+#endif
+    base = static_cast<double*>(view);
+    n = size;
+    mappedBytes = bytes;
+    return true;
+}
+
+void MappedMatrix::close() {
+#ifdef _WIN32
+    if (base) UnmapViewOfFile(base);
+    if (mappingHandle) CloseHandle(static_cast<HANDLE>(mappingHandle));
+    if (fileHandle) CloseHandle(static_cast<HANDLE>(fileHandle));  // Deletes the file
+    mappingHandle = nullptr;
+    fileHandle = nullptr;
+#else
+    if (base) munmap(base, mappedBytes);
+    if (fd >= 0) ::close(fd);  // Already unlinked; this frees the space
+    fd = -1;
+#endif
+    base = nullptr;
+    n = 0;
+    mappedBytes = 0;
+}
+
+void MappedMatrix::copyRow(std::size_t i, double* out) const {
+    std::memcpy(out, row(i), n * sizeof(double));
+}
+
+void MappedMatrix::releaseRows(std::size_t firstRow, std::size_t lastRow) const {
+    if (!base || lastRow <= firstRow) return;
+    char* begin = reinterpret_cast<char*>(base + firstRow * n);
+    char* end = reinterpret_cast<char*>(base + std::min(lastRow, n) * n);
+#ifdef _WIN32
+    VirtualUnlock(begin, end - begin);  // Lets the working-set manager trim the rows
+#else
+    // madvise wants a page-aligned start; the pages are file-backed, so
+    // dropping part of a neighbouring row only costs a refault
+    const std::uintptr_t page = static_cast<std::uintptr_t>(sysconf(_SC_PAGESIZE));
+    char* aligned = reinterpret_cast<char*>(reinterpret_cast<std::uintptr_t>(begin) & ~(page - 1));
+    madvise(aligned, end - aligned, MADV_DONTNEED);
+#endif
+}
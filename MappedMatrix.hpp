@@ -0,0 +1,53 @@
+#ifndef MAPPEDMATRIX_HPP
+#define MAPPEDMATRIX_HPP
+
+#include <string>
+#include <cstddef>
+
+// Disk-backed n x n matrix of doubles stored row-major on a memory-mapped
+// file. The assignment solvers read whole rows in no particular order, so
+// each row is one contiguous span and a row read faults in exactly that row,
+// keeping the resident set far below 8*n^2 bytes.
+class MappedMatrix {
+public:
+    MappedMatrix();
+    ~MappedMatrix();
+    MappedMatrix(const MappedMatrix&) = delete;
+    MappedMatrix& operator=(const MappedMatrix&) = delete;
+
+    // Create a uniquely named backing file in directory and map it. The file
+    // is unlinked (POSIX) or marked delete-on-close (Windows) as soon as it is
+    // open, so nothing is left behind even if the process dies.
+    bool open(const std::string& directory, std::size_t size);
+    void close();
+    bool isOpen() const { return base != nullptr; }
+
+    std::size_t rows() const { return n; }
+    std::size_t columns() const { return n; }
+    std::size_t fileBytes() const { return mappedBytes; }
+
+    double& operator()(std::size_t i, std::size_t j) { return base[i * n + j]; }
+    const double& operator()(std::size_t i, std::size_t j) const { return base[i * n + j]; }
+
+    double* row(std::size_t i) { return base + i * n; }
+    const double* row(std::size_t i) const { return base + i * n; }
+
+    // Copy row i into out[0..n)
+    void copyRow(std::size_t i, double* out) const;
+
+    // Let the OS drop rows [firstRow, lastRow) from the resident set
+    void releaseRows(std::size_t firstRow, std::size_t lastRow) const;
+
+private:
+    double* base;
+    std::size_t n;
+    std::size_t mappedBytes;
+#ifdef _WIN32
+    void* fileHandle;
+    void* mappingHandle;
+#else
+    int fd;
+#endif
+};
+
+#endif // MAPPEDMATRIX_HPP
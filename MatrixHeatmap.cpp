@@ -0,0 +1,239 @@
+#include "MatrixHeatmap.hpp"
+#include "AssignmentBackend.hpp"
+#include "RenderUtils.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // Alpha carries the cell's priority through the mip reduction
+    const unsigned char PADDING = 0;
+    const unsigned char NORMAL = 253;
+    const unsigned char FORBIDDEN = 254;
+    const unsigned char ASSIGNED = 255;
+
+    // Dark blue -> cyan -> yellow
+    void colormap(float t, unsigned char* rgb) {
+        t = std::clamp(t, 0.0f, 1.0f);
+        float r, g, b;
+        if (t < 0.5f) {
+            float s = t * 2.0f;
+            r = 0.05f;
+            g = 0.05f + 0.55f * s;
+            b = 0.3f + 0.5f * s;
+        } else {
+            float s = (t - 0.5f) * 2.0f;
+            r = s;
+            g = 0.6f + 0.3f * s;
+            b = 0.8f - 0.6f * s;
+        }
+        rgb[0] = static_cast<unsigned char>(255.0f * r);
+        rgb[1] = static_cast<unsigned char>(255.0f * g);
+        rgb[2] = static_cast<unsigned char>(255.0f * b);
+    }
+
+    void setCell(unsigned char* pixel, unsigned char r, unsigned char g, unsigned char b, unsigned char priority) {
+        pixel[0] = r;
+        pixel[1] = g;
+        pixel[2] = b;
+        pixel[3] = priority;
+    }
+}
+
+void MatrixHeatmap::reset(const CityStore& cities) {
+    clear();
+    if (cities.size() < 2 || cities.size() > static_cast<std::size_t>(MAX_CITIES)) return;
+    int padded = 1;
+    while (padded < static_cast<int>(cities.size())) padded *= 2;
+    GLint maxTexture = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTexture);
+    if (padded > maxTexture) return;
+
+    n = static_cast<int>(cities.size());
+    texSize = padded;
+    xs.assign(cities.origXData(), cities.origXData() + n);
+    ys.assign(cities.origYData(), cities.origYData() + n);
+    auto [minX, maxX] = std::minmax_element(xs.begin(), xs.end());
+    auto [minY, maxY] = std::minmax_element(ys.begin(), ys.end());
+    scale = std::max(std::hypot(*maxX - *minX, *maxY - *minY), 1e-6f);
+}
+
+void MatrixHeatmap::clear() {
+    n = 0;
+    texSize = 0;
+    xs.clear();
+    ys.clear();
+    forbidden.clear();
+    forbiddenBefore.clear();
+    duals.clear();
+    builtIndex = -1;
+}
+
+void MatrixHeatmap::record(const HungarianStepper& stepper) {
+    if (n == 0) return;
+    const std::vector<std::pair<int, int>>& added = stepper.newlyForbidden();
+    if (stepper.iteration() > 0) forbidden.insert(forbidden.end(), added.begin(), added.end());
+    forbiddenBefore.push_back(forbidden.size());
+
+    const AssignmentResult& result = stepper.assignmentResult();
+    std::vector<float> stepDuals;
+    if (result.hasDuals()) {
+        stepDuals.reserve(2 * n);
+        stepDuals.insert(stepDuals.end(), result.u.begin(), result.u.end());
+        stepDuals.insert(stepDuals.end(), result.v.begin(), result.v.end());
+    }
+    duals.push_back(std::move(stepDuals));
+}
+
+bool MatrixHeatmap::hasDuals(int stepIndex) const {
+    return stepIndex >= 0 && stepIndex < static_cast<int>(duals.size()) && !duals[stepIndex].empty();
+}
+
+// Level 0: the colour of every cell, and padding up to texSize
+void MatrixHeatmap::buildBase(int stepIndex, View view) {
+    pixels.resize(static_cast<std::size_t>(texSize) * texSize * 4);
+    const float* u = view == View::ReducedCosts ? duals[stepIndex].data() : nullptr;
+    const float* v = u ? u + n : nullptr;
+    const float logScale = std::log1p(scale);
+    const float tight = 1e-4f * scale;
+
+    for (int i = 0; i < n; i++) {
+        unsigned char* row = cell(i, 0);
+        std::fill(row + 4 * n, row + 4 * texSize, PADDING);
+        for (int j = 0; j < n; j++) {
+            unsigned char* pixel = row + 4 * j;
+            if (i == j) {
+                setCell(pixel, 60, 60, 60, FORBIDDEN);  // Self-loops are infinite too
+                continue;
+            }
+            float dx = xs[i] - xs[j], dy = ys[i] - ys[j];
+            float d = std::sqrt(dx * dx + dy * dy);
+            if (u) {
+                // Zero reduced cost: the edges the assignment may use without any change in duals
+                float reduced = d - u[i] - v[j];
+                if (reduced <= tight) {
+                    setCell(pixel, 0, 200, 90, NORMAL);
+                } else {
+                    colormap(std::log1p(reduced) / logScale, pixel);
+                    pixel[3] = NORMAL;
+                }
+            } else {
+                colormap(d / scale, pixel);
+                pixel[3] = NORMAL;
+            }
+        }
+    }
+
+    std::fill(pixels.begin() + static_cast<std::ptrdiff_t>(n) * texSize * 4, pixels.end(), PADDING);
+
+    std::size_t forbiddenCount = stepIndex < static_cast<int>(forbiddenBefore.size()) ? forbiddenBefore[stepIndex] : 0;
+    for (std::size_t k = 0; k < forbiddenCount; k++) {
+        auto [from, to] = forbidden[k];
+        setCell(cell(from, to), 230, 30, 30, FORBIDDEN);
+    }
+}
+
+// Level 0 plus a mip chain; each 2x2 block keeps its highest-priority cell,
+// and only the plain cells of a block are averaged, so padding never bleeds
+// in. Each level is reduced in place over the one before it, which is safe
+// because a block's source cells never lie before the texel it writes.
+void MatrixHeatmap::upload() {
+    if (texture == 0) glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
+
+    unsigned char* level = pixels.data();
+    int size = texSize;
+    for (int mip = 0;; mip++) {
+        glTexImage2D(GL_TEXTURE_2D, mip, GL_RGBA, size, size, 0, GL_RGBA, GL_UNSIGNED_BYTE, level);
+        if (size == 1) break;
+
+        int half = size / 2;
+        for (int y = 0; y < half; y++) {
+            for (int x = 0; x < half; x++) {
+                unsigned char top[4] = {0, 0, 0, PADDING};
+                int sum[3] = {0, 0, 0}, count = 0;
+                for (int sy = 2 * y; sy < 2 * y + 2; sy++) {
+                    for (int sx = 2 * x; sx < 2 * x + 2; sx++) {
+                        const unsigned char* src = &level[(static_cast<std::size_t>(sy) * size + sx) * 4];
+                        if (src[3] > top[3]) std::copy(src, src + 4, top);
+                        if (src[3] != NORMAL) continue;
+                        for (int c = 0; c < 3; c++) sum[c] += src[c];
+                        count++;
+                    }
+                }
+
+                unsigned char* out = &level[(static_cast<std::size_t>(y) * half + x) * 4];
+                if (top[3] != NORMAL) {
+                    setCell(out, top[0], top[1], top[2], top[3]);
+                } else {
+                    setCell(out, static_cast<unsigned char>(sum[0] / count), static_cast<unsigned char>(sum[1] / count),
+                            static_cast<unsigned char>(sum[2] / count), NORMAL);
+                }
+            }
+        }
+        size = half;
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void MatrixHeatmap::setStep(const TSPStep& step, int stepIndex, View view) {
+    if (view == View::ReducedCosts && !hasDuals(stepIndex)) view = View::Costs;
+    if (n == 0 || (stepIndex == builtIndex && view == builtView)) return;
+    builtIndex = stepIndex;
+    builtView = view;
+
+    buildBase(stepIndex, view);
+    for (const auto& [from, to] : step.assignment) {
+        if (from >= 0 && from < n && to >= 0 && to < n) {
+            setCell(cell(from, to), 255, 255, 255, ASSIGNED);
+        }
+    }
+    upload();
+}
+
+void MatrixHeatmap::draw(int winWidth, int winHeight) const {
+    if (n == 0 || builtIndex < 0) return;
+
+    // Pixel-space square below the step info, left of the matrix panel
+    float size = std::max(std::min(winHeight - 200.0f, winWidth * 0.45f), 64.0f);
+    float left = 20.0f, top = 110.0f;
+
+    glMatrixMode(GL_PROJECTION);
+    glPushMatrix();
+    glLoadIdentity();
+    glOrtho(0, winWidth, winHeight, 0, -1, 1);
+    glMatrixMode(GL_MODELVIEW);
+    glPushMatrix();
+    glLoadIdentity();
+
+    glEnable(GL_TEXTURE_2D);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_REPLACE);
+    // Only the n x n corner of the padded texture
+    float extent = static_cast<float>(n) / texSize;
+    glBegin(GL_QUADS);
+    glTexCoord2f(0.0f, 0.0f); glVertex2f(left, top);
+    glTexCoord2f(extent, 0.0f); glVertex2f(left + size, top);
+    glTexCoord2f(extent, extent); glVertex2f(left + size, top + size);
+    glTexCoord2f(0.0f, extent); glVertex2f(left, top + size);
+    glEnd();
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glDisable(GL_TEXTURE_2D);
+
+    glPopMatrix();
+    glMatrixMode(GL_PROJECTION);
+    glPopMatrix();
+    glMatrixMode(GL_MODELVIEW);
+
+    // Legend just below the square
+    float legendY = 1.0f - (top + size + 18.0f) / winHeight * 2.0f;
+    glColor3f(0.9f, 0.9f, 0.9f);
+    RenderUtils::drawText(left / winWidth * 2.0f - 1.0f, legendY,
+                          builtView == View::ReducedCosts
+                              ? "Reduced costs (log) | green: zero | white: assigned | red: forbidden | H: next view"
+                              : "Distances | white: assigned | red: forbidden | H: next view");
+}
@@ -0,0 +1,60 @@
+#ifndef MATRIXHEATMAP_HPP
+#define MATRIXHEATMAP_HPP
+
+#include "CityStore.hpp"
+#include "TSPAlgorithm.hpp"
+#include <GL/freeglut.h>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// n x n view of the cost matrix (row = from city, column = to city) for
+// instances up to MAX_CITIES. Cells are coloured by distance, or by reduced
+// cost c(i,j) - u[i] - v[j] from the step's assignment duals, with forbidden
+// (infinite) cells in red and the step's assignment in white. The texture is
+// rebuilt once per step and view, with a mip chain whose 2x2 reduction keeps
+// assignment and forbidden cells over averaging them away, so they stay
+// visible when thousands of rows share a few hundred pixels. The texture is
+// padded to a power of two so plain OpenGL 1.1 can use it.
+class MatrixHeatmap {
+public:
+    static const int MAX_CITIES = 4096;
+
+    enum class View { Costs, ReducedCosts };
+
+    // Start of a solve: take the city coordinates and drop recorded steps
+    void reset(const CityStore& cities);
+    void clear();
+
+    // After each solver step: its forbidden edges and duals
+    void record(const HungarianStepper& stepper);
+
+    bool available() const { return n > 0; }
+    bool hasDuals(int stepIndex) const;
+
+    // Rebuild and upload the texture if the step or the view changed
+    void setStep(const TSPStep& step, int stepIndex, View view);
+
+    // Square at the left of the window, with a legend
+    void draw(int winWidth, int winHeight) const;
+
+private:
+    void buildBase(int stepIndex, View view);
+    void upload();
+    unsigned char* cell(int from, int to) { return &pixels[(static_cast<std::size_t>(from) * texSize + to) * 4]; }
+
+    int n = 0;
+    int texSize = 0;                                 // Smallest power of two >= n
+    std::vector<float> xs, ys;                       // Original coordinates
+    float scale = 1.0f;                              // Largest possible distance
+    std::vector<std::pair<int, int>> forbidden;      // In the order they were forbidden
+    std::vector<std::size_t> forbiddenBefore;        // Per step: prefix of forbidden in effect
+    std::vector<std::vector<float>> duals;           // Per step: u then v (empty without duals)
+
+    std::vector<unsigned char> pixels;               // RGBA, alpha = cell priority; upload() consumes it
+    GLuint texture = 0;
+    int builtIndex = -1;
+    View builtView = View::Costs;
+};
+
+#endif // MATRIXHEATMAP_HPP
@@ -1,134 +1,185 @@
 #include "MatrixPanel.hpp"
 #include "RenderUtils.hpp"
 #include <GL/freeglut.h>
-#include <sstream>
-#include <iomanip>
+#include <algorithm>
+#include <charconv>
 #include <cmath>
 
-void MatrixPanel::draw(const std::vector<City>& cities, const TSPStep& step) {
-    int n = cities.size();
-    if (n == 0) return;
-    
+namespace {
+    const float PANEL_X = 0.45f;
+    const float PANEL_Y = 0.35f;
+    const float PANEL_WIDTH = 0.5f;
+    const float PANEL_HEIGHT = 0.8f;
+    const float BODY_TOP = PANEL_Y + PANEL_HEIGHT - 0.18f;  // Baseline of the first body row
+    const float BODY_BOTTOM = PANEL_Y + 0.12f;              // Lowest body baseline
+    const float ROW_STEP = 0.045f;
+
+    const std::size_t MEMBERS_PER_ROW = 8;
+    const std::size_t EDGES_PER_ROW = 3;
+
+    const float SUBTOUR_COLORS[][3] = {
+        {0.0f, 1.0f, 0.0f},  // Green
+        {1.0f, 0.0f, 0.0f},  // Red
+        {1.0f, 1.0f, 0.0f},  // Yellow
+        {1.0f, 0.0f, 1.0f},  // Magenta
+        {0.0f, 1.0f, 1.0f},  // Cyan
+    };
+    const float TITLE[] = {1.0f, 1.0f, 0.0f};
+    const float INFO[] = {0.8f, 0.8f, 1.0f};
+    const float WHITE[] = {1.0f, 1.0f, 1.0f};
+    const float GREY[] = {0.7f, 0.7f, 0.7f};
+    const float COMPLETE[] = {0.0f, 1.0f, 0.0f};
+    const float PATCHING[] = {1.0f, 0.5f, 0.0f};
+
+    void appendNumber(std::string& out, long long value) {
+        char buffer[24];
+        auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        out.append(buffer, result.ptr);
+    }
+}
+
+void MatrixPanel::addRow(std::vector<Row>& target, const std::string& text, const float* color) {
+    target.push_back({static_cast<std::uint32_t>(arena.size()), color[0], color[1], color[2]});
+    arena += text;
+    arena += '\0';
+}
+
+void MatrixPanel::setStep(const CityStore& cities, const TSPStep& step, int stepIndex) {
+    if (stepIndex == builtIndex) return;
+    builtIndex = stepIndex;
+    arena.clear();
+    header.clear();
+    rows.clear();
+    footer.clear();
+
+    std::string text = "Assignment Matrix - Iteration ";
+    appendNumber(text, step.iteration);
+    addRow(header, text, TITLE);
+    text = "Subtours detected: ";
+    appendNumber(text, static_cast<long long>(step.subtours.size()));
+    addRow(header, text, INFO);
+
+    // Every member of every subtour, MEMBERS_PER_ROW to a row
+    for (std::size_t i = 0; i < step.subtours.size(); i++) {
+        const std::vector<int>& subtour = step.subtours[i];
+        const float* color = SUBTOUR_COLORS[i % 5];
+        for (std::size_t begin = 0; begin < subtour.size() || begin == 0; begin += MEMBERS_PER_ROW) {
+            if (begin == 0) {
+                text = "  Subtour ";
+                appendNumber(text, static_cast<long long>(i));
+                text += " (size ";
+                appendNumber(text, static_cast<long long>(subtour.size()));
+                text += "): ";
+            } else {
+                text = "      ";
+            }
+            std::size_t end = std::min(begin + MEMBERS_PER_ROW, subtour.size());
+            for (std::size_t j = begin; j < end; j++) {
+                appendNumber(text, subtour[j]);
+                if (j + 1 < subtour.size()) text += "->";
+            }
+            addRow(rows, text, color);
+            if (subtour.empty()) break;
+        }
+    }
+
+    addRow(rows, "", WHITE);
+    text = "Assignment Edges (";
+    appendNumber(text, static_cast<long long>(step.assignment.size()));
+    text += "):";
+    addRow(rows, text, WHITE);
+
+    // Every edge with its length, EDGES_PER_ROW to a row
+    for (std::size_t begin = 0; begin < step.assignment.size(); begin += EDGES_PER_ROW) {
+        text = "  ";
+        std::size_t end = std::min(begin + EDGES_PER_ROW, step.assignment.size());
+        for (std::size_t e = begin; e < end; e++) {
+            auto [from, to] = step.assignment[e];
+            double dx = cities.origX(from) - cities.origX(to);
+            double dy = cities.origY(from) - cities.origY(to);
+            if (e > begin) text += " | ";
+            appendNumber(text, from);
+            text += "->";
+            appendNumber(text, to);
+            text += "(";
+            appendNumber(text, std::llround(std::sqrt(dx * dx + dy * dy)));
+            text += ")";
+        }
+        addRow(rows, text, GREY);
+    }
+
+    if (step.isFinalTour) {
+        addRow(footer, "STATUS: COMPLETE TOUR FOUND!", COMPLETE);
+    } else {
+        addRow(footer, "STATUS: Patching subtours...", PATCHING);
+    }
+
+    // Keep the scroll position when stepping, as far as the new rows allow
+    scroll(0);
+}
+
+int MatrixPanel::visibleRows() const {
+    return static_cast<int>((BODY_TOP - BODY_BOTTOM) / ROW_STEP) + 1;
+}
+
+void MatrixPanel::scroll(int delta) {
+    int lastFirst = std::max(static_cast<int>(rows.size()) - visibleRows(), 0);
+    firstRow = std::clamp(firstRow + delta, 0, lastFirst);
+}
+
+bool MatrixPanel::contains(float x, float y) const {
+    return x >= PANEL_X && x <= PANEL_X + PANEL_WIDTH && y >= PANEL_Y && y <= PANEL_Y + PANEL_HEIGHT;
+}
+
+void MatrixPanel::draw() const {
+    if (builtIndex < 0) return;
+
     // Panel background
     glColor4f(0.0f, 0.0f, 0.0f, 0.7f);
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    
-    float panelWidth = 0.5f;
-    float panelHeight = 0.8f;
-    float panelX = 0.45f;
-    float panelY = 0.35f;
-    
     glBegin(GL_QUADS);
-    glVertex2f(panelX, panelY);
-    glVertex2f(panelX + panelWidth, panelY);
-    glVertex2f(panelX + panelWidth, panelY + panelHeight);
-    glVertex2f(panelX, panelY + panelHeight);
+    glVertex2f(PANEL_X, PANEL_Y);
+    glVertex2f(PANEL_X + PANEL_WIDTH, PANEL_Y);
+    glVertex2f(PANEL_X + PANEL_WIDTH, PANEL_Y + PANEL_HEIGHT);
+    glVertex2f(PANEL_X, PANEL_Y + PANEL_HEIGHT);
     glEnd();
-    
     glDisable(GL_BLEND);
-    
-    // Title
-    glColor3f(1.0f, 1.0f, 0.0f);
-    RenderUtils::drawText(panelX + 0.02f, panelY + panelHeight - 0.05f, 
-                         ("Assignment Matrix - Iteration " + std::to_string(step.iteration)).c_str());
-    
-    // Subtour info
-    float yPos = panelY + panelHeight - 0.12f;
-    glColor3f(0.8f, 0.8f, 1.0f);
-    
-    std::string subtourInfo = "Subtours detected: " + std::to_string(step.subtours.size());
-    RenderUtils::drawText(panelX + 0.02f, yPos, subtourInfo.c_str());
-    yPos -= 0.06f;
-    
-    // List each subtour
-    for (size_t i = 0; i < step.subtours.size(); i++) {
-        std::stringstream ss;
-        ss << "  Subtour " << i << " (size " << step.subtours[i].size() << "): ";
-        
-        for (size_t j = 0; j < step.subtours[i].size() && j < 8; j++) {
-            ss << step.subtours[i][j];
-            if (j < step.subtours[i].size() - 1) ss << "->";
-        }
-        if (step.subtours[i].size() > 8) ss << "...";
-        
-        const float colors[][3] = {
-            {0.0f, 1.0f, 0.0f},  // Green
-            {1.0f, 0.0f, 0.0f},  // Red
-            {1.0f, 1.0f, 0.0f},  // Yellow
-            {1.0f, 0.0f, 1.0f},  // Magenta
-            {0.0f, 1.0f, 1.0f},  // Cyan
-        };
-        glColor3fv(colors[i % 5]);
-        
-        RenderUtils::drawText(panelX + 0.04f, yPos, ss.str().c_str());
-        yPos -= 0.05f;
+
+    // Title and subtour count
+    float yPos = PANEL_Y + PANEL_HEIGHT - 0.05f;
+    for (const Row& row : header) {
+        glColor3f(row.r, row.g, row.b);
+        RenderUtils::drawText(PANEL_X + 0.02f, yPos, arena.data() + row.offset);
+        yPos -= 0.07f;
     }
-    
-    yPos -= 0.03f;
-    
-    // Assignment edges
-    glColor3f(1.0f, 1.0f, 1.0f);
-    RenderUtils::drawText(panelX + 0.02f, yPos, "Assignment Edges:");
-    yPos -= 0.05f;
-    
-    // Display assignment in compact form with wrapping
-    int edgeCount = 0;
-    std::stringstream lineSS;
-    int itemsInLine = 0;
-    const int maxItemsPerLine = 3;  // Show 3 edges per line
-    
-    for (const auto& [from, to] : step.assignment) {
-        if (edgeCount >= 12) {  // Show up to 12 edges (4 lines)
-            if (itemsInLine > 0) {
-                glColor3f(0.7f, 0.7f, 0.7f);
-                RenderUtils::drawText(panelX + 0.04f, yPos, lineSS.str().c_str());
-                yPos -= 0.04f;
-            }
-            RenderUtils::drawText(panelX + 0.04f, yPos, "...");
-            yPos -= 0.04f;
-            break;
-        }
-        
-        // Calculate distance
-        double dx = cities[from].orig_x - cities[to].orig_x;
-        double dy = cities[from].orig_y - cities[to].orig_y;
-        double dist = std::sqrt(dx * dx + dy * dy);
-        
-        // Add to current line
-        if (itemsInLine > 0) {
-            lineSS << " | ";
-        }
-        lineSS << from << "->" << to << "(" << std::fixed << std::setprecision(0) << dist << ")";
-        itemsInLine++;
-        
-        // Wrap to next line if needed
-        if (itemsInLine >= maxItemsPerLine) {
-            glColor3f(0.7f, 0.7f, 0.7f);
-            RenderUtils::drawText(panelX + 0.04f, yPos, lineSS.str().c_str());
-            yPos -= 0.04f;
-            lineSS.str("");
-            lineSS.clear();
-            itemsInLine = 0;
-        }
-        
-        edgeCount++;
+
+    // The rows on screen
+    int lastRow = std::min(firstRow + visibleRows(), static_cast<int>(rows.size()));
+    yPos = BODY_TOP;
+    for (int i = firstRow; i < lastRow; i++) {
+        const Row& row = rows[i];
+        glColor3f(row.r, row.g, row.b);
+        RenderUtils::drawText(PANEL_X + 0.02f, yPos, arena.data() + row.offset);
+        yPos -= ROW_STEP;
     }
-    
-    // Print remaining items if any
-    if (itemsInLine > 0) {
-        glColor3f(0.7f, 0.7f, 0.7f);
-        RenderUtils::drawText(panelX + 0.04f, yPos, lineSS.str().c_str());
-        yPos -= 0.04f;
+
+    // Status, plus the position when there is more than fits
+    yPos = PANEL_Y + 0.06f;
+    for (const Row& row : footer) {
+        glColor3f(row.r, row.g, row.b);
+        RenderUtils::drawText(PANEL_X + 0.02f, yPos, arena.data() + row.offset);
+        yPos -= ROW_STEP;
     }
-    
-    // Status
-    yPos -= 0.03f;
-    if (step.isFinalTour) {
-        glColor3f(0.0f, 1.0f, 0.0f);
-        RenderUtils::drawText(panelX + 0.02f, yPos, "STATUS: COMPLETE TOUR FOUND!");
-    } else {
-        glColor3f(1.0f, 0.5f, 0.0f);
-        RenderUtils::drawText(panelX + 0.02f, yPos, "STATUS: Patching subtours...");
+    if (static_cast<int>(rows.size()) > visibleRows()) {
+        std::string position = "Rows ";
+        appendNumber(position, firstRow + 1);
+        position += "-";
+        appendNumber(position, lastRow);
+        position += " of ";
+        appendNumber(position, static_cast<long long>(rows.size()));
+        position += " | PgUp/PgDn, wheel";
+        glColor3f(GREY[0], GREY[1], GREY[2]);
+        RenderUtils::drawText(PANEL_X + 0.02f, PANEL_Y + 0.015f, position);
     }
 }
@@ -1,13 +1,48 @@
 ﻿#ifndef MATRIXPANEL_HPP
 #define MATRIXPANEL_HPP
 
-#include "City.hpp"
+#include "CityStore.hpp"
 #include "TSPAlgorithm.hpp"
+#include <string>
 #include <vector>
 
+// Side panel listing a step's subtours and assignment edges. The formatted
+// rows are built once per step (all of them, not just the first few) and
+// kept until the step changes; drawing only walks the rows on screen.
+// The body scrolls by row or by page.
 class MatrixPanel {
 public:
-    static void draw(const std::vector<City>& cities, const TSPStep& step);
+    // Rebuild the rows if stepIndex is not the step they were built for
+    void setStep(const CityStore& cities, const TSPStep& step, int stepIndex);
+
+    // Force the next setStep to rebuild (the steps were replaced)
+    void invalidate() { builtIndex = -1; }
+
+    void draw() const;
+
+    void scroll(int rows);
+    void page(int pages) { scroll(pages * visibleRows()); }
+    void scrollToTop() { firstRow = 0; }
+    void scrollToEnd() { scroll(static_cast<int>(rows.size())); }
+
+    // Whether a point in normalised device coordinates is over the panel
+    bool contains(float x, float y) const;
+
+private:
+    struct Row {
+        std::uint32_t offset;  // Text in the arena, NUL-terminated
+        float r, g, b;
+    };
+
+    void addRow(std::vector<Row>& target, const std::string& text, const float* color);
+    int visibleRows() const;
+
+    std::string arena;  // All row texts back to back
+    std::vector<Row> header;
+    std::vector<Row> rows;  // Scrollable body
+    std::vector<Row> footer;
+    int builtIndex = -1;
+    int firstRow = 0;
 };
 
 #endif // MATRIXPANEL_HPP
@@ -0,0 +1,102 @@
+#include "Quadtree.hpp"
+#include <algorithm>
+#include <numeric>
+
+namespace {
+    const std::uint32_t LEAF_ITEMS = 16;
+    const int MAX_DEPTH = 20;  // Stops the split on piles of identical points
+
+    // 0 when the box crosses a midline, else 1 + its quadrant
+    int slotOf(const Box& box, float midX, float midY) {
+        int col = box.maxX <= midX ? 0 : (box.minX >= midX ? 1 : -1);
+        int row = box.maxY <= midY ? 0 : (box.minY >= midY ? 1 : -1);
+        if (col < 0 || row < 0) return 0;
+        return 1 + row * 2 + col;
+    }
+}
+
+void Quadtree::build(std::vector<Box> items) {
+    boxes = std::move(items);
+    nodes.clear();
+    order.resize(boxes.size());
+    std::iota(order.begin(), order.end(), 0u);
+    if (boxes.empty()) {
+        dataBounds = {0.0f, 0.0f, 0.0f, 0.0f};
+        return;
+    }
+
+    dataBounds = boxes[0];
+    for (const Box& box : boxes) {
+        dataBounds.minX = std::min(dataBounds.minX, box.minX);
+        dataBounds.minY = std::min(dataBounds.minY, box.minY);
+        dataBounds.maxX = std::max(dataBounds.maxX, box.maxX);
+        dataBounds.maxY = std::max(dataBounds.maxY, box.maxY);
+    }
+    scratch.resize(boxes.size());
+    buildNode(dataBounds, 0, static_cast<std::uint32_t>(order.size()), 0);
+}
+
+void Quadtree::clear() {
+    boxes.clear();
+    order.clear();
+    nodes.clear();
+    dataBounds = {0.0f, 0.0f, 0.0f, 0.0f};
+}
+
+int Quadtree::buildNode(const Box& cell, std::uint32_t begin, std::uint32_t end, int depth) {
+    int index = static_cast<int>(nodes.size());
+    nodes.push_back({cell, begin, end, end, {-1, -1, -1, -1}});
+    if (end - begin <= LEAF_ITEMS || depth >= MAX_DEPTH) return index;
+
+    float midX = 0.5f * (cell.minX + cell.maxX);
+    float midY = 0.5f * (cell.minY + cell.maxY);
+
+    // Counting sort of the range by slot: straddling items first, then each quadrant
+    std::uint32_t starts[6] = {0, 0, 0, 0, 0, 0};
+    for (std::uint32_t i = begin; i < end; i++) {
+        starts[slotOf(boxes[order[i]], midX, midY) + 1]++;
+    }
+    starts[0] = begin;
+    for (int s = 1; s < 6; s++) starts[s] += starts[s - 1];
+    std::uint32_t fill[5] = {starts[0], starts[1], starts[2], starts[3], starts[4]};
+    for (std::uint32_t i = begin; i < end; i++) {
+        scratch[fill[slotOf(boxes[order[i]], midX, midY)]++] = order[i];
+    }
+    std::copy(scratch.begin() + begin, scratch.begin() + end, order.begin() + begin);
+    nodes[index].ownEnd = starts[1];
+
+    const Box quadrants[4] = {
+        {cell.minX, cell.minY, midX, midY},
+        {midX, cell.minY, cell.maxX, midY},
+        {cell.minX, midY, midX, cell.maxY},
+        {midX, midY, cell.maxX, cell.maxY},
+    };
+    for (int q = 0; q < 4; q++) {
+        if (starts[q + 1] == starts[q + 2]) continue;
+        int child = buildNode(quadrants[q], starts[q + 1], starts[q + 2], depth + 1);
+        nodes[index].children[q] = child;  // nodes may have grown, so no reference is held across the call
+    }
+    return index;
+}
+
+void Quadtree::query(const Box& area, std::vector<std::uint32_t>& out) const {
+    if (nodes.empty()) return;
+
+    std::vector<int> stack{0};
+    while (!stack.empty()) {
+        const Node& node = nodes[stack.back()];
+        stack.pop_back();
+        if (!area.intersects(node.cell)) continue;
+
+        if (area.contains(node.cell)) {
+            out.insert(out.end(), order.begin() + node.begin, order.begin() + node.end);
+            continue;
+        }
+        for (std::uint32_t i = node.begin; i < node.ownEnd; i++) {
+            if (area.intersects(boxes[order[i]])) out.push_back(order[i]);
+        }
+        for (int child : node.children) {
+            if (child >= 0) stack.push_back(child);
+        }
+    }
+}
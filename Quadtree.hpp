@@ -0,0 +1,54 @@
+#ifndef QUADTREE_HPP
+#define QUADTREE_HPP
+
+#include <cstdint>
+#include <vector>
+
+// Axis-aligned rectangle; a point is a box with min == max
+struct Box {
+    float minX, minY, maxX, maxY;
+
+    bool intersects(const Box& other) const {
+        return minX <= other.maxX && other.minX <= maxX && minY <= other.maxY && other.minY <= maxY;
+    }
+    bool contains(const Box& other) const {
+        return minX <= other.minX && other.maxX <= maxX && minY <= other.minY && other.maxY <= maxY;
+    }
+    bool operator==(const Box& other) const {
+        return minX == other.minX && minY == other.minY && maxX == other.maxX && maxY == other.maxY;
+    }
+};
+
+// Static region quadtree over boxes, rebuilt whenever the boxes change.
+// Each box sits in the smallest cell that holds it whole, so long edges stay
+// near the root. Item ids are stored so that every subtree is one contiguous
+// run, and a cell lying entirely inside the query area is copied out without
+// testing its items.
+class Quadtree {
+public:
+    void build(std::vector<Box> items);
+    void clear();
+
+    // Append the ids (positions in the built vector) of all boxes touching area
+    void query(const Box& area, std::vector<std::uint32_t>& out) const;
+
+    std::size_t size() const { return boxes.size(); }
+    const Box& bounds() const { return dataBounds; }
+
+private:
+    struct Node {
+        Box cell;
+        std::uint32_t begin, ownEnd, end;  // [begin, ownEnd) straddle the midlines; [begin, end) is the subtree
+        int children[4];
+    };
+
+    int buildNode(const Box& cell, std::uint32_t begin, std::uint32_t end, int depth);
+
+    std::vector<Box> boxes;
+    std::vector<std::uint32_t> order;    // Item ids, grouped by node
+    std::vector<std::uint32_t> scratch;  // Partition buffer while building
+    std::vector<Node> nodes;
+    Box dataBounds{0.0f, 0.0f, 0.0f, 0.0f};
+};
+
+#endif // QUADTREE_HPP
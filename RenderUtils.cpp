@@ -1,16 +1,120 @@
 ﻿#include "RenderUtils.hpp"
 #include <GL/freeglut.h>
 #include <string>
+#include <vector>
+#include <unordered_map>
+#include <cmath>
 
-namespace RenderUtils {
-    void drawText(float x, float y, const std::string& text) {
-        glRasterPos2f(x, y);
-        for (char c : text) {
-            glutBitmapCharacter(GLUT_BITMAP_9_BY_15, c);
+namespace {
+    // Atlas layout: printable ASCII in a 16 x 6 grid of cells. Cells are wider
+    // and taller than the font so no glyph is clipped; DESCENT is the gap below
+    // the baseline, which is where glRasterPos puts the bitmap origin.
+    const int FIRST_CHAR = 32;
+    const int CHAR_COUNT = 96;
+    const int COLUMNS = 16;
+    const int CELL_W = 10;
+    const int CELL_H = 20;
+    const int DESCENT = 5;
+    const int ATLAS_W = 256;
+    const int ATLAS_H = 128;
+    const size_t MAX_CACHED_STRINGS = 8192;
+
+    struct TextVertex {
+        float x, y, u, v;
+        unsigned char r, g, b, a;
+    };
+
+    // Glyph quads of one string, relative to its baseline origin
+    struct CachedString {
+        std::vector<float> quads;  // x0, y0, x1, y1, u0, v0, u1, v1 per glyph
+    };
+
+    GLuint atlasTexture = 0;
+    bool atlasReady = false;
+    int advance = 9;
+    int viewportW = 1, viewportH = 1;
+    std::vector<TextVertex> batch;
+    std::unordered_map<std::string, CachedString> cache;
+
+    // Render every glyph with glutBitmapCharacter and read the result back
+    bool buildAtlas() {
+        GLint viewport[4];
+        glGetIntegerv(GL_VIEWPORT, viewport);
+        if (viewport[2] < COLUMNS * CELL_W || viewport[3] < (CHAR_COUNT / COLUMNS) * CELL_H) return false;
+        advance = glutBitmapWidth(GLUT_BITMAP_9_BY_15, 'M');
+
+        glMatrixMode(GL_PROJECTION);
+        glPushMatrix();
+        glLoadIdentity();
+        glOrtho(0, viewport[2], 0, viewport[3], -1, 1);
+        glMatrixMode(GL_MODELVIEW);
+        glPushMatrix();
+        glLoadIdentity();
+
+        GLfloat clearColor[4];
+        glGetFloatv(GL_COLOR_CLEAR_VALUE, clearColor);
+        glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+        glColor3f(1.0f, 1.0f, 1.0f);
+        for (int c = 0; c < CHAR_COUNT; c++) {
+            glRasterPos2i((c % COLUMNS) * CELL_W, (c / COLUMNS) * CELL_H + DESCENT);
+            glutBitmapCharacter(GLUT_BITMAP_9_BY_15, FIRST_CHAR + c);
+        }
+
+        std::vector<unsigned char> rgb(COLUMNS * CELL_W * (CHAR_COUNT / COLUMNS) * CELL_H * 3);
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+        glReadBuffer(GL_BACK);
+        glReadPixels(0, 0, COLUMNS * CELL_W, (CHAR_COUNT / COLUMNS) * CELL_H, GL_RGB, GL_UNSIGNED_BYTE, rgb.data());
+
+        glClearColor(clearColor[0], clearColor[1], clearColor[2], clearColor[3]);
+        glPopMatrix();
+        glMatrixMode(GL_PROJECTION);
+        glPopMatrix();
+        glMatrixMode(GL_MODELVIEW);
+
+        // Coverage goes into the alpha channel; the colour comes from the vertices
+        std::vector<unsigned char> alpha(ATLAS_W * ATLAS_H, 0);
+        for (int y = 0; y < (CHAR_COUNT / COLUMNS) * CELL_H; y++) {
+            for (int x = 0; x < COLUMNS * CELL_W; x++) {
+                alpha[y * ATLAS_W + x] = rgb[(y * COLUMNS * CELL_W + x) * 3];
+            }
         }
+
+        glGenTextures(1, &atlasTexture);
+        glBindTexture(GL_TEXTURE_2D, atlasTexture);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA, ATLAS_W, ATLAS_H, 0, GL_ALPHA, GL_UNSIGNED_BYTE, alpha.data());
+        glBindTexture(GL_TEXTURE_2D, 0);
+        return true;
     }
-    
-    void drawText(float x, float y, const char* text) {
+
+    const CachedString& layout(const char* text) {
+        auto it = cache.find(text);
+        if (it != cache.end()) return it->second;
+        if (cache.size() >= MAX_CACHED_STRINGS) cache.clear();  // Per-frame strings (timings etc.)
+
+        CachedString& entry = cache[text];
+        int penX = 0;
+        for (const char* p = text; *p; p++) {
+            int c = static_cast<unsigned char>(*p) - FIRST_CHAR;
+            if (c > 0 && c < CHAR_COUNT) {  // Space and unsupported characters only advance
+                float u0 = float((c % COLUMNS) * CELL_W) / ATLAS_W;
+                float v0 = float((c / COLUMNS) * CELL_H) / ATLAS_H;
+                float q[8] = {
+                    float(penX), float(-DESCENT), float(penX + CELL_W), float(CELL_H - DESCENT),
+                    u0, v0, u0 + float(CELL_W) / ATLAS_W, v0 + float(CELL_H) / ATLAS_H
+                };
+                entry.quads.insert(entry.quads.end(), q, q + 8);
+            }
+            penX += advance;
+        }
+        return entry;
+    }
+
+    // Fallback when the atlas could not be built (e.g. a tiny window)
+    void drawBitmapText(float x, float y, const char* text) {
         glRasterPos2f(x, y);
         while (*text) {
             glutBitmapCharacter(GLUT_BITMAP_9_BY_15, *text);
@@ -18,3 +122,86 @@ namespace RenderUtils {
         }
     }
 }
+
+namespace RenderUtils {
+    void beginFrame() {
+        if (!atlasReady) atlasReady = buildAtlas();
+        GLint viewport[4];
+        glGetIntegerv(GL_VIEWPORT, viewport);
+        viewportW = viewport[2] > 0 ? viewport[2] : 1;
+        viewportH = viewport[3] > 0 ? viewport[3] : 1;
+    }
+
+    void drawText(float x, float y, const std::string& text) {
+        drawText(x, y, text.c_str());
+    }
+
+    void drawText(float x, float y, const char* text) {
+        if (!atlasReady) {
+            drawBitmapText(x, y, text);
+            return;
+        }
+
+        GLfloat color[4];
+        glGetFloatv(GL_CURRENT_COLOR, color);
+        unsigned char r = static_cast<unsigned char>(color[0] * 255.0f + 0.5f);
+        unsigned char g = static_cast<unsigned char>(color[1] * 255.0f + 0.5f);
+        unsigned char b = static_cast<unsigned char>(color[2] * 255.0f + 0.5f);
+        unsigned char a = static_cast<unsigned char>(color[3] * 255.0f + 0.5f);
+
+        // Snap the baseline origin to a whole pixel so glyphs stay crisp
+        float originX = std::floor((x + 1.0f) * 0.5f * viewportW + 0.5f);
+        float originY = std::floor((y + 1.0f) * 0.5f * viewportH + 0.5f);
+
+        const std::vector<float>& quads = layout(text).quads;
+        for (size_t q = 0; q < quads.size(); q += 8) {
+            float x0 = originX + quads[q], y0 = originY + quads[q + 1];
+            float x1 = originX + quads[q + 2], y1 = originY + quads[q + 3];
+            float u0 = quads[q + 4], v0 = quads[q + 5], u1 = quads[q + 6], v1 = quads[q + 7];
+            batch.push_back({x0, y0, u0, v0, r, g, b, a});
+            batch.push_back({x1, y0, u1, v0, r, g, b, a});
+            batch.push_back({x1, y1, u1, v1, r, g, b, a});
+            batch.push_back({x0, y1, u0, v1, r, g, b, a});
+        }
+    }
+
+    void flushText() {
+        if (batch.empty()) return;
+
+        glMatrixMode(GL_PROJECTION);
+        glPushMatrix();
+        glLoadIdentity();
+        glOrtho(0, viewportW, 0, viewportH, -1, 1);
+        glMatrixMode(GL_MODELVIEW);
+        glPushMatrix();
+        glLoadIdentity();
+
+        glEnable(GL_TEXTURE_2D);
+        glBindTexture(GL_TEXTURE_2D, atlasTexture);
+        glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+        glEnableClientState(GL_VERTEX_ARRAY);
+        glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+        glEnableClientState(GL_COLOR_ARRAY);
+        glVertexPointer(2, GL_FLOAT, sizeof(TextVertex), &batch[0].x);
+        glTexCoordPointer(2, GL_FLOAT, sizeof(TextVertex), &batch[0].u);
+        glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(TextVertex), &batch[0].r);
+        glDrawArrays(GL_QUADS, 0, static_cast<GLsizei>(batch.size()));
+        glDisableClientState(GL_COLOR_ARRAY);
+        glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+        glDisableClientState(GL_VERTEX_ARRAY);
+
+        glDisable(GL_BLEND);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glDisable(GL_TEXTURE_2D);
+
+        glPopMatrix();
+        glMatrixMode(GL_PROJECTION);
+        glPopMatrix();
+        glMatrixMode(GL_MODELVIEW);
+
+        batch.clear();
+    }
+}
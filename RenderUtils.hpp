@@ -3,9 +3,20 @@
 
 #include <string>
 
+// Text is drawn from a glyph atlas: GLUT's 9x15 bitmap font is rasterised into
+// a texture once, and drawText() only queues textured quads (in the current
+// colour) until flushText() draws them in one batch. Glyph geometry is cached
+// per string, so labels that repeat every frame are not laid out again.
 namespace RenderUtils {
+    // Build the atlas if needed and pick up the viewport; call at the start of
+    // a frame, before glClear (building the atlas draws into the back buffer)
+    void beginFrame();
+
     void drawText(float x, float y, const std::string& text);
     void drawText(float x, float y, const char* text);
+
+    // Draw all queued text; call before anything that must cover it
+    void flushText();
 }
 
 #endif
@@ -0,0 +1,41 @@
+#include "SalesmanPath.hpp"
+#include <algorithm>
+#include <cmath>
+
+void SalesmanPath::build(const CityStore& cities, const std::vector<int>& newTour) {
+    tour = newTour;
+    cumulative.assign(tour.size() + 1, 0.0);
+    for (std::size_t k = 0; k < tour.size(); k++) {
+        int from = tour[k];
+        int to = tour[(k + 1) % tour.size()];
+        double dx = cities.x(to) - cities.x(from);
+        double dy = cities.y(to) - cities.y(from);
+        cumulative[k + 1] = cumulative[k] + std::sqrt(dx * dx + dy * dy);
+    }
+}
+
+void SalesmanPath::clear() {
+    tour.clear();
+    cumulative.clear();
+}
+
+void SalesmanPath::locate(const CityStore& cities, double distance, float& x, float& y) const {
+    if (tour.empty()) return;
+    double total = length();
+    if (total <= 0.0) {
+        x = cities.x(tour[0]);
+        y = cities.y(tour[0]);
+        return;
+    }
+    double d = std::fmod(distance, total);
+    if (d < 0.0) d += total;
+
+    // Last edge starting at or before d; zero-length edges are skipped over
+    std::size_t edge = std::upper_bound(cumulative.begin() + 1, cumulative.end() - 1, d) - cumulative.begin() - 1;
+    int from = tour[edge];
+    int to = tour[(edge + 1) % tour.size()];
+    double span = cumulative[edge + 1] - cumulative[edge];
+    float t = span > 0.0 ? static_cast<float>((d - cumulative[edge]) / span) : 0.0f;
+    x = cities.x(from) + (cities.x(to) - cities.x(from)) * t;
+    y = cities.y(from) + (cities.y(to) - cities.y(from)) * t;
+}
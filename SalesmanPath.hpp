@@ -0,0 +1,30 @@
+#ifndef SALESMANPATH_HPP
+#define SALESMANPATH_HPP
+
+#include "CityStore.hpp"
+#include <cstddef>
+#include <vector>
+
+// Arc-length parameterisation of a closed tour for the salesman animation.
+// cumulative[k] is the distance from the first city to tour[k] along the
+// tour, so a position is found by binary search in O(log n) and the
+// salesman moves at the same world speed over short and long edges.
+class SalesmanPath {
+public:
+    void build(const CityStore& cities, const std::vector<int>& tour);
+    void clear();
+
+    bool empty() const { return tour.size() < 2; }
+    double length() const { return cumulative.empty() ? 0.0 : cumulative.back(); }
+    double meanEdge() const { return empty() ? 0.0 : length() / tour.size(); }
+
+    // World position at a distance along the tour (wrapped to one lap);
+    // cities must be the ones the path was built from
+    void locate(const CityStore& cities, double distance, float& x, float& y) const;
+
+private:
+    std::vector<int> tour;
+    std::vector<double> cumulative;  // tour.size() + 1 entries; the last closes the loop
+};
+
+#endif // SALESMANPATH_HPP
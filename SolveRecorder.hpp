@@ -0,0 +1,124 @@
+#ifndef SOLVERECORDER_HPP
+#define SOLVERECORDER_HPP
+
+#include "TSPAlgorithm.hpp"
+#include "StepHistory.hpp"
+#include "Logger.hpp"
+#include <cstdio>
+
+// Recorders observe a solve through three hooks. Every hook is an inline
+// no-op in NullRecorder, so TSPAlgorithm::solve<NullRecorder> is the bare
+// patching loop with no per-iteration copies, strings or log calls.
+// STEP_DETAIL says whether the hooks read the stepper's assignment pairs,
+// newly forbidden edges or per-iteration subtour counts; without it the
+// stepper does not produce them.
+struct NullRecorder {
+    static constexpr bool STEP_DETAIL = false;
+
+    void onStart(const HungarianStepper&) {}
+    void onStep(const HungarianStepper&) {}
+    void onFinish(const HungarianStepper&, const SolveResult&) {}
+};
+
+// Reports every iteration, subtour and forbidden edge through the async logger
+// (info: per-iteration summary, debug: subtour members and forbidden edges)
+struct LogRecorder {
+    static constexpr bool STEP_DETAIL = true;
+
+    void onStart(const HungarianStepper& stepper) {
+        TSP_LOG(LogLevel::Info, LogCategory::Solver, "=== Starting Hungarian TSP Solver with %d cities ===",
+                stepper.cityCount());
+    }
+
+    void onStep(const HungarianStepper& stepper) {
+        if (stepper.iteration() == 0) {
+            TSP_LOG(LogLevel::Info, LogCategory::Matrix, "Initial distance matrix built%s",
+                    stepper.usesOutOfCore() ? " (out-of-core)" : stepper.usesPackedMatrix() ? " (packed)" : "");
+        }
+        if (Log::enabled(LogLevel::Debug)) {
+            for (const auto& [from, to] : stepper.newlyForbidden()) {
+                TSP_LOG(LogLevel::Debug, LogCategory::Patch, "Forbidding edge: %d -> %d", from, to);
+            }
+        }
+
+        const SubtourList& subtours = stepper.subtours();
+        TSP_LOG(LogLevel::Info, LogCategory::Assign, "--- Iteration %d --- assignment found: %zu edges",
+                stepper.iteration(), stepper.assignment().size());
+        TSP_LOG(LogLevel::Info, LogCategory::Subtour, "Detected %zu subtour(s)", subtours.count());
+        if (Log::enabled(LogLevel::Debug)) {
+            logSubtourMembers(subtours);
+        }
+
+        if (stepper.foundTour()) {
+            TSP_LOG(LogLevel::Info, LogCategory::Solver, "SUCCESS: Found complete tour in iteration %d, length %.3f",
+                    stepper.iteration(),
+                    TSPAlgorithm::calculateTourLength(stepper.cityStore(), stepper.assignment()));
+        }
+    }
+
+    void onFinish(const HungarianStepper&, const SolveResult& result) {
+        TSP_LOG(LogLevel::Info, LogCategory::Solver, "=== Solver finished with %d steps ===", result.iterations);
+    }
+
+private:
+    // Member lists can be long, so they are split over several records
+    static void logSubtourMembers(const SubtourList& subtours) {
+        char line[400];
+        for (size_t i = 0; i < subtours.count(); i++) {
+            int len = std::snprintf(line, sizeof(line), "Subtour %zu (size %zu):", i, subtours.size(i));
+            for (size_t k = 0; k < subtours.size(i); k++) {
+                if (len > (int)sizeof(line) - 16) {
+                    TSP_LOG(LogLevel::Debug, LogCategory::Subtour, "%s", line);
+                    len = std::snprintf(line, sizeof(line), "  ...");
+                }
+                len += std::snprintf(line + len, sizeof(line) - len, " %d", subtours.members(i)[k]);
+            }
+            TSP_LOG(LogLevel::Debug, LogCategory::Subtour, "%s", line);
+        }
+    }
+};
+
+// Keeps every step in a StepHistory (for the visualiser) and logs like LogRecorder
+struct HistoryRecorder : LogRecorder {
+    StepHistory& history;
+
+    explicit HistoryRecorder(StepHistory& history) : history(history) {}
+
+    void onStart(const HungarianStepper& stepper) {
+        history.clear();
+        LogRecorder::onStart(stepper);
+    }
+
+    void onStep(const HungarianStepper& stepper) {
+        // Only the edges that changed since the previous step are stored
+        history.push(stepper.successor(), stepper.iteration());
+        LogRecorder::onStep(stepper);
+    }
+};
+
+template<class Recorder>
+SolveResult TSPAlgorithm::solve(const CityStore& cities, Recorder& recorder, SolverWorkspace& ws,
+                                const SolverOptions& options) {
+    SolveResult result;
+    HungarianStepper stepper(cities, ws, options);
+    stepper.setStepDetail(Recorder::STEP_DETAIL);
+
+    recorder.onStart(stepper);
+    while (stepper.next()) {
+        recorder.onStep(stepper);
+    }
+
+    result.iterations = stepper.iteration() + 1;
+    result.foundTour = stepper.foundTour();
+    result.timedOut = stepper.timedOut();
+    if (stepper.iteration() >= 0) {
+        // A converged solve is a single subtour; otherwise splice the last ones together
+        mergeSubtours(cities, stepper.subtours(), result.tour);
+        result.length = calculateTourLength(cities, result.tour);
+    }
+    result.metrics = stepper.metrics();
+    recorder.onFinish(stepper, result);
+    return result;
+}
+
+#endif // SOLVERECORDER_HPP
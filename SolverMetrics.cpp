@@ -0,0 +1,107 @@
+#include "SolverMetrics.hpp"
+#include "json.hpp"
+#include <sstream>
+#include <iomanip>
+using json = nlohmann::json;
+
+const char* phaseName(SolverPhase phase) {
+    switch (phase) {
+        case SolverPhase::Matrix:  return "matrix";
+        case SolverPhase::Assign:  return "assign";
+        case SolverPhase::Extract: return "extract";
+        case SolverPhase::Subtour: return "subtour";
+        case SolverPhase::Patch:   return "patch";
+        default:                   return "?";
+    }
+}
+
+void SolverMetrics::reset() {
+    for (int p = 0; p < PHASES; p++) {
+        phaseSeconds[p] = 0.0;
+        phaseCalls[p] = 0;
+    }
+    cities = 0;
+    iterations = 0;
+    stepDetail = true;
+    subtoursPerIteration.clear();
+    firstSubtours = 0;
+    lastSubtours = 0;
+    maxSubtours = 0;
+    workspaceGrowthBytes = 0;
+    workspaceBytes = 0;
+    foundTour = false;
+    tourLength = 0.0;
+}
+
+double SolverMetrics::totalSeconds() const {
+    double total = 0.0;
+    for (int p = 0; p < PHASES; p++) total += phaseSeconds[p];
+    return total;
+}
+
+// Without step detail the extraction and per-iteration series are left out:
+// zeros would read as "none", not "not recorded"
+std::string SolverMetrics::toJson() const {
+    json phases = json::object();
+    for (int p = 0; p < PHASES; p++) {
+        if (!stepDetail && p == static_cast<int>(SolverPhase::Extract)) continue;
+        phases[phaseName(static_cast<SolverPhase>(p))] = {
+            {"seconds", phaseSeconds[p]},
+            {"calls", phaseCalls[p]}
+        };
+    }
+    json j = {
+        {"cities", cities},
+        {"iterations", iterations},
+        {"found_tour", foundTour},
+        {"tour_length", tourLength},
+        {"total_seconds", totalSeconds()},
+        {"phases", phases},
+        {"step_detail", stepDetail},
+        {"subtours_first", firstSubtours},
+        {"subtours_last", lastSubtours},
+        {"subtours_max", maxSubtours},
+        {"workspace_growth_bytes", workspaceGrowthBytes},
+        {"workspace_bytes", workspaceBytes}
+    };
+    if (stepDetail) j["subtours_per_iteration"] = subtoursPerIteration;
+    return j.dump();
+}
+
+std::string SolverMetrics::toPrometheus(const std::string& prefix) const {
+    std::ostringstream out;
+    out << "# TYPE " << prefix << "_phase_seconds gauge\n";
+    for (int p = 0; p < PHASES; p++) {
+        if (!stepDetail && p == static_cast<int>(SolverPhase::Extract)) continue;
+        out << prefix << "_phase_seconds{phase=\"" << phaseName(static_cast<SolverPhase>(p)) << "\"} "
+            << phaseSeconds[p] << "\n";
+    }
+    out << "# TYPE " << prefix << "_phase_calls gauge\n";
+    for (int p = 0; p < PHASES; p++) {
+        if (!stepDetail && p == static_cast<int>(SolverPhase::Extract)) continue;
+        out << prefix << "_phase_calls{phase=\"" << phaseName(static_cast<SolverPhase>(p)) << "\"} "
+            << phaseCalls[p] << "\n";
+    }
+    out << "# TYPE " << prefix << "_cities gauge\n" << prefix << "_cities " << cities << "\n";
+    out << "# TYPE " << prefix << "_iterations gauge\n" << prefix << "_iterations " << iterations << "\n";
+    // One series per statistic, not per iteration, so the label set stays fixed
+    out << "# TYPE " << prefix << "_subtours gauge\n";
+    out << prefix << "_subtours{stat=\"first\"} " << firstSubtours << "\n";
+    out << prefix << "_subtours{stat=\"last\"} " << lastSubtours << "\n";
+    out << prefix << "_subtours{stat=\"max\"} " << maxSubtours << "\n";
+    out << "# TYPE " << prefix << "_workspace_growth_bytes gauge\n" << prefix << "_workspace_growth_bytes "
+        << workspaceGrowthBytes << "\n";
+    out << "# TYPE " << prefix << "_workspace_bytes gauge\n" << prefix << "_workspace_bytes " << workspaceBytes << "\n";
+    out << "# TYPE " << prefix << "_tour_length gauge\n" << prefix << "_tour_length " << tourLength << "\n";
+    return out.str();
+}
+
+std::string SolverMetrics::summary() const {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(1);
+    for (int p = 0; p < PHASES; p++) {
+        out << phaseName(static_cast<SolverPhase>(p)) << " " << phaseSeconds[p] * 1000.0 << "ms | ";
+    }
+    out << iterations << " iters | " << workspaceBytes / 1024 << " KB";
+    return out.str();
+}
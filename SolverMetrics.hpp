@@ -0,0 +1,61 @@
+#ifndef SOLVERMETRICS_HPP
+#define SOLVERMETRICS_HPP
+
+#include <vector>
+#include <string>
+#include <cstddef>
+#include <chrono>
+
+// Solver phases; names match the logger categories
+enum class SolverPhase { Matrix = 0, Assign, Extract, Subtour, Patch, Count };
+
+const char* phaseName(SolverPhase phase);
+
+// Per-solve instrumentation collected by HungarianStepper
+struct SolverMetrics {
+    static constexpr int PHASES = static_cast<int>(SolverPhase::Count);
+
+    double phaseSeconds[PHASES];
+    long long phaseCalls[PHASES];
+    int cities;
+    int iterations;
+    bool stepDetail;                        // Whether the Extract phase and subtoursPerIteration were
+                                            // recorded (see HungarianStepper); left out of the output if not
+    std::vector<int> subtoursPerIteration;
+    int firstSubtours;                      // Subtours of the first assignment
+    int lastSubtours;                       // Subtours of the latest assignment
+    int maxSubtours;
+    std::size_t workspaceGrowthBytes;  // Growth of the solver's buffers during this solve (0 on a warm
+                                       // workspace; not a count of allocations)
+    std::size_t workspaceBytes;   // Footprint of the solver's buffers at the end of the solve
+    bool foundTour;
+    double tourLength;
+
+    SolverMetrics() { reset(); }
+    void reset();
+
+    double seconds(SolverPhase phase) const { return phaseSeconds[static_cast<int>(phase)]; }
+    double totalSeconds() const;
+
+    std::string toJson() const;
+    std::string toPrometheus(const std::string& prefix = "tsp_solver") const;
+    std::string summary() const;  // One line for the on-screen overlay
+};
+
+// Adds the lifetime of the scope to one phase
+class ScopedPhaseTimer {
+public:
+    ScopedPhaseTimer(SolverMetrics& metrics, SolverPhase phase)
+        : metrics(metrics), phase(static_cast<int>(phase)), start(std::chrono::steady_clock::now()) {}
+    ~ScopedPhaseTimer() {
+        metrics.phaseSeconds[phase] += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        metrics.phaseCalls[phase]++;
+    }
+
+private:
+    SolverMetrics& metrics;
+    int phase;
+    std::chrono::steady_clock::time_point start;
+};
+
+#endif // SOLVERMETRICS_HPP
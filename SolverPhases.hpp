@@ -0,0 +1,32 @@
+#ifndef SOLVERPHASES_HPP
+#define SOLVERPHASES_HPP
+
+#include "TSPAlgorithm.hpp"
+#include "SolverWorkspace.hpp"
+#include <utility>
+#include <vector>
+
+// The phases of one patching iteration, as HungarianStepper runs them.
+// Internal to the solver and its benchmarks; applications go through
+// TSPAlgorithm and HungarianStepper.
+namespace SolverPhases {
+    // Build symmetric distance matrix from cities (packed, upper triangle only)
+    void buildDistanceMatrix(const CityStore& cities, SymmetricMatrix<double>& distances);
+    
+    // The same, dense, with every row contiguous
+    void buildDistanceMatrix(const CityStore& cities, SquareMatrix<double>& distances);
+    
+    // Build the on-disk distance matrix used for very large instances
+    void buildDistanceMatrix(const CityStore& cities, MappedMatrix& distances);
+    
+    // Convert the backend's row -> column permutation into (from, to) pairs
+    void extractAssignment(const AssignmentResult& result, std::vector<std::pair<int, int>>& assignment);
+    
+    // Detect all subtours in the workspace's current assignment
+    void findSubtours(SolverWorkspace& ws, int n);
+    
+    // Forbid edges in subtours (recorded as directed edges with infinite cost)
+    void forbidSubtourEdges(std::vector<std::pair<int, int>>& forbidden, const SubtourList& subtours, int minSize);
+}
+
+#endif // SOLVERPHASES_HPP
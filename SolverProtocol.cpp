@@ -0,0 +1,162 @@
+#include "SolverProtocol.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+// Little-endian field access, independent of the host byte order
+void putU32(std::string& out, uint32_t v) {
+    char b[4] = {char(v), char(v >> 8), char(v >> 16), char(v >> 24)};
+    out.append(b, 4);
+}
+
+void putU64(std::string& out, uint64_t v) {
+    putU32(out, static_cast<uint32_t>(v));
+    putU32(out, static_cast<uint32_t>(v >> 32));
+}
+
+void putF32(std::string& out, float f) {
+    uint32_t v;
+    std::memcpy(&v, &f, 4);
+    putU32(out, v);
+}
+
+void putF64(std::string& out, double d) {
+    uint64_t v;
+    std::memcpy(&v, &d, 8);
+    putU64(out, v);
+}
+
+uint32_t getU32(const char* p) {
+    const unsigned char* b = reinterpret_cast<const unsigned char*>(p);
+    return uint32_t(b[0]) | uint32_t(b[1]) << 8 | uint32_t(b[2]) << 16 | uint32_t(b[3]) << 24;
+}
+
+uint64_t getU64(const char* p) {
+    return uint64_t(getU32(p)) | uint64_t(getU32(p + 4)) << 32;
+}
+
+float getF32(const char* p) {
+    uint32_t v = getU32(p);
+    float f;
+    std::memcpy(&f, &v, 4);
+    return f;
+}
+
+double getF64(const char* p) {
+    uint64_t v = getU64(p);
+    double d;
+    std::memcpy(&d, &v, 8);
+    return d;
+}
+
+const std::size_t REQUEST_FIXED = 8 + 4 + 4 + 4 + 4;
+const std::size_t RESPONSE_FIXED = 8 + 4 + 4 + 8 + 4;
+
+// Header with a placeholder length, patched once the payload is written
+std::size_t beginFrame(std::string& out, uint32_t magic) {
+    putU32(out, magic);
+    putU32(out, 0);
+    return out.size();
+}
+
+void endFrame(std::string& out, std::size_t payloadStart) {
+    uint32_t bytes = static_cast<uint32_t>(out.size() - payloadStart);
+    std::string length;
+    putU32(length, bytes);
+    out.replace(payloadStart - 4, 4, length);
+}
+
+}
+
+namespace SolverProtocol {
+
+long long frameSize(const char* buffer, std::size_t available, uint32_t expectedMagic) {
+    if (available < HEADER_BYTES) return 0;
+    if (getU32(buffer) != expectedMagic) return -1;
+    uint64_t payload = getU32(buffer + 4);
+    // Requests and responses are both bounded by MAX_CITIES points
+    if (payload > std::max(REQUEST_FIXED, RESPONSE_FIXED) + 8ull * MAX_CITIES) return -1;
+    uint64_t total = HEADER_BYTES + payload;
+    return available >= total ? static_cast<long long>(total) : 0;
+}
+
+void encodeRequest(const Request& request, std::string& out) {
+    std::size_t start = beginFrame(out, REQUEST_MAGIC);
+    putU64(out, request.id);
+    putU32(out, static_cast<uint32_t>(request.points.size()));
+    putU32(out, request.options.engine == AssignmentEngine::Munkres ? 1u : 0u);
+    putF32(out, static_cast<float>(request.options.timeLimit));
+    putU32(out, static_cast<uint32_t>(request.options.maxIterations));
+    for (const auto& [x, y] : request.points) {
+        putF32(out, x);
+        putF32(out, y);
+    }
+    endFrame(out, start);
+}
+
+bool decodeRequest(const char* frame, std::size_t bytes, Request& request) {
+    if (bytes < HEADER_BYTES + REQUEST_FIXED || getU32(frame) != REQUEST_MAGIC) return false;
+    const char* p = frame + HEADER_BYTES;
+    request.id = getU64(p);
+    uint32_t count = getU32(p + 8);
+    uint32_t flags = getU32(p + 12);
+    float timeLimit = getF32(p + 16);
+    uint32_t maxIterations = getU32(p + 20);
+    if (count > MAX_CITIES || bytes != HEADER_BYTES + REQUEST_FIXED + 8ull * count) return false;
+    if ((flags & 0xff) > 1 || !(timeLimit >= 0.0f)) return false;
+
+    request.options = SolverOptions();
+    request.options.engine = (flags & 0xff) == 1 ? AssignmentEngine::Munkres : AssignmentEngine::Hungarian;
+    request.options.timeLimit = timeLimit;
+    if (maxIterations > 0) request.options.maxIterations = static_cast<int>(std::min<uint32_t>(maxIterations, 1u << 30));
+
+    p += REQUEST_FIXED;
+    request.points.resize(count);
+    for (uint32_t i = 0; i < count; i++) {
+        request.points[i] = {getF32(p), getF32(p + 4)};
+        p += 8;
+    }
+    return true;
+}
+
+void encodeResponse(const Response& response, std::string& out) {
+    std::size_t start = beginFrame(out, RESPONSE_MAGIC);
+    putU64(out, response.id);
+    putU32(out, static_cast<uint32_t>(response.status));
+    putU32(out, response.iterations);
+    putF64(out, response.length);
+    putU32(out, static_cast<uint32_t>(response.tour.size()));
+    for (uint32_t city : response.tour) putU32(out, city);
+    endFrame(out, start);
+}
+
+bool decodeResponse(const char* frame, std::size_t bytes, Response& response) {
+    if (bytes < HEADER_BYTES + RESPONSE_FIXED || getU32(frame) != RESPONSE_MAGIC) return false;
+    const char* p = frame + HEADER_BYTES;
+    response.id = getU64(p);
+    response.status = static_cast<Status>(getU32(p + 8) & 0xff);
+    response.iterations = getU32(p + 12);
+    response.length = getF64(p + 16);
+    uint32_t size = getU32(p + 24);
+    if (size > MAX_CITIES || bytes != HEADER_BYTES + RESPONSE_FIXED + 4ull * size) return false;
+
+    p += RESPONSE_FIXED;
+    response.tour.resize(size);
+    for (uint32_t i = 0; i < size; i++) response.tour[i] = getU32(p + 4 * i);
+    return true;
+}
+
+Response makeResponse(uint64_t id, const SolveResult& result) {
+    Response response;
+    response.id = id;
+    response.status = result.foundTour ? Status::Converged
+                    : result.timedOut ? Status::TimedOut
+                    : Status::IterationLimit;
+    response.iterations = static_cast<uint32_t>(result.iterations);
+    response.length = result.length;
+    response.tour.assign(result.tour.begin(), result.tour.end());
+    return response;
+}
+
+}
@@ -0,0 +1,62 @@
+#ifndef SOLVERPROTOCOL_HPP
+#define SOLVERPROTOCOL_HPP
+
+#include "TSPAlgorithm.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Binary framing used by tspd. Every frame is an 8-byte header followed by
+// the payload; all integers and floats are little-endian.
+//
+//   header   : u32 magic, u32 payload bytes
+//   request  : magic "TSPQ"; u64 id, u32 city count, u8 engine (0 hungarian,
+//              1 munkres), u8[3] zero, f32 time limit (s, 0 = none),
+//              u32 max iterations (0 = default), then count x (f32 x, f32 y)
+//   response : magic "TSPR"; u64 id, u8 status, u8[3] zero, u32 iterations,
+//              f64 length, u32 tour size, then size x u32 city index
+//
+// Responses carry the request's id; on one connection they may arrive out of order.
+namespace SolverProtocol {
+    const uint32_t REQUEST_MAGIC = 0x51505354;   // "TSPQ"
+    const uint32_t RESPONSE_MAGIC = 0x52505354;  // "TSPR"
+    const std::size_t HEADER_BYTES = 8;
+    const uint32_t MAX_CITIES = 1u << 20;  // Frame limit only; tspd refuses far smaller requests (--max-cities)
+
+    enum class Status : uint8_t {
+        Converged = 0,       // Patching found a single tour
+        TimedOut = 1,        // Time limit hit; subtours spliced into a tour
+        IterationLimit = 2,  // Iteration limit hit; subtours spliced into a tour
+        BadRequest = 3,      // Malformed frame, too many cities or an engine not built in; no tour
+        Failed = 4           // The solve itself failed (e.g. out of memory); no tour
+    };
+
+    struct Request {
+        uint64_t id;
+        SolverOptions options;
+        std::vector<std::pair<float, float>> points;
+    };
+
+    struct Response {
+        uint64_t id;
+        Status status;
+        uint32_t iterations;
+        double length;
+        std::vector<uint32_t> tour;
+    };
+
+    // Bytes of the complete frame at the front of buffer, 0 if it is still
+    // incomplete, or -1 if the header is invalid (wrong magic or oversized)
+    long long frameSize(const char* buffer, std::size_t available, uint32_t expectedMagic);
+
+    void encodeRequest(const Request& request, std::string& out);
+    bool decodeRequest(const char* frame, std::size_t bytes, Request& request);
+
+    void encodeResponse(const Response& response, std::string& out);
+    bool decodeResponse(const char* frame, std::size_t bytes, Response& response);
+
+    Response makeResponse(uint64_t id, const SolveResult& result);
+}
+
+#endif // SOLVERPROTOCOL_HPP
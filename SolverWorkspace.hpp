@@ -0,0 +1,43 @@
+#ifndef SOLVERWORKSPACE_HPP
+#define SOLVERWORKSPACE_HPP
+
+#include "TSPAlgorithm.hpp"
+#include "AssignmentBackend.hpp"
+#include <vector>
+#include <utility>
+
+// Buffers reused across patching iterations and across solves. They only ever
+// grow, so once a thread has solved an instance of a given size the loop does
+// no allocation of its own (munkres-cpp still manages its internal masks).
+struct SolverWorkspace {
+    // Persistent distances (dense, packed for large instances, or mapped for out-of-core ones)
+    SymmetricMatrix<double> distances;
+    SquareMatrix<double> denseDistances;
+    MappedMatrix mappedDistances;
+    std::vector<std::pair<int, int>> forbidden;
+    
+    // Assignment backends and their output
+    HungarianBackend hungarian;
+#if TSP_WITH_MUNKRES
+    MunkresBackend munkres;
+#endif
+    AssignmentResult assignmentResult;
+    std::vector<int> raisedRows;  // Rows whose assigned edge was forbidden last iteration
+    std::vector<std::pair<int, int>> newlyForbidden;
+    std::vector<std::pair<int, int>> assignment;
+    
+    // Subtour detection
+    std::vector<char> visited;
+    SubtourList subtours;
+    
+    // Give all memory back (e.g. after an unusually large instance)
+    void release();
+    
+    // Bytes currently held by the in-memory buffers (the mapped file is not counted)
+    std::size_t bytes() const;
+    
+    // The calling thread's pooled workspace
+    static SolverWorkspace& local();
+};
+
+#endif // SOLVERWORKSPACE_HPP
@@ -0,0 +1,47 @@
+#ifndef SQUAREMATRIX_HPP
+#define SQUAREMATRIX_HPP
+
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+
+// Dense row-major n x n storage. Twice the memory of SymmetricMatrix for a
+// symmetric matrix, but a whole row is one contiguous read instead of a
+// strided gather through the lower triangle.
+template<class T>
+class SquareMatrix {
+public:
+    SquareMatrix() : n(0) {}
+    explicit SquareMatrix(std::size_t size, const T& value = T()) { resize(size, value); }
+
+    void resize(std::size_t size, const T& value = T()) {
+        n = size;
+        data.assign(n * n, value);
+    }
+
+    void clear() {
+        n = 0;
+        data.clear();
+        data.shrink_to_fit();
+    }
+
+    std::size_t rows() const { return n; }
+    std::size_t columns() const { return n; }
+    std::size_t bytes() const { return data.capacity() * sizeof(T); }
+
+    T& operator()(std::size_t i, std::size_t j) { return data[i * n + j]; }
+    const T& operator()(std::size_t i, std::size_t j) const { return data[i * n + j]; }
+
+    const T* row(std::size_t i) const { return data.data() + i * n; }
+    T* row(std::size_t i) { return data.data() + i * n; }
+
+    void copyRow(std::size_t i, T* out) const {
+        std::copy(row(i), row(i) + n, out);
+    }
+
+private:
+    std::size_t n;
+    std::vector<T> data;
+};
+
+#endif // SQUAREMATRIX_HPP
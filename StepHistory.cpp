@@ -0,0 +1,105 @@
+#include "StepHistory.hpp"
+
+static const std::size_t NONE = static_cast<std::size_t>(-1);
+
+StepHistory::StepHistory(int keyframeInterval)
+    : keyframeInterval(keyframeInterval > 0 ? keyframeInterval : 1),
+      deltaStart(1, 0), cursorIndex(NONE), cachedIndex(NONE) {}
+
+void StepHistory::clear() {
+    keyframes.clear();
+    deltas.clear();
+    deltaStart.assign(1, 0);
+    iterations.clear();
+    lastSuccessor.clear();
+    cursor.clear();
+    cursorIndex = NONE;
+    cachedStep = TSPStep();
+    cachedIndex = NONE;
+}
+
+void StepHistory::push(const std::vector<int>& successor, int iteration) {
+    std::size_t index = iterations.size();
+    if (index % keyframeInterval == 0) {
+        keyframes.push_back(successor);
+    }
+    if (index > 0) {
+        for (std::size_t i = 0; i < successor.size(); i++) {
+            if (successor[i] != lastSuccessor[i]) {
+                deltas.push_back({ static_cast<int>(i), lastSuccessor[i], successor[i] });
+            }
+        }
+    }
+    deltaStart.push_back(deltas.size());
+    iterations.push_back(iteration);
+    lastSuccessor = successor;
+}
+
+void StepHistory::push(const TSPStep& step) {
+    std::vector<int> successor(step.assignment.size(), -1);
+    for (const auto& [from, to] : step.assignment) {
+        successor[from] = to;
+    }
+    push(successor, step.iteration);
+}
+
+// Move the cursor to index, from the current position or the nearest keyframe
+void StepHistory::seek(std::size_t index) const {
+    std::size_t keyIndex = index / keyframeInterval;
+    std::size_t keyStep = keyIndex * keyframeInterval;
+    bool cursorUsable = cursorIndex != NONE &&
+        (cursorIndex > index ? cursorIndex - index : index - cursorIndex) <= index - keyStep;
+    if (!cursorUsable) {
+        cursor = keyframes[keyIndex];
+        cursorIndex = keyStep;
+    }
+    while (cursorIndex < index) {
+        cursorIndex++;
+        for (std::size_t d = deltaStart[cursorIndex]; d < deltaStart[cursorIndex + 1]; d++) {
+            cursor[deltas[d].city] = deltas[d].newNext;
+        }
+    }
+    while (cursorIndex > index) {
+        for (std::size_t d = deltaStart[cursorIndex]; d < deltaStart[cursorIndex + 1]; d++) {
+            cursor[deltas[d].city] = deltas[d].oldNext;
+        }
+        cursorIndex--;
+    }
+}
+
+const std::vector<int>& StepHistory::successorAt(std::size_t index) const {
+    seek(index);
+    return cursor;
+}
+
+const TSPStep& StepHistory::operator[](std::size_t index) const {
+    if (index == cachedIndex) return cachedStep;
+    seek(index);
+
+    cachedStep.iteration = iterations[index];
+    cachedStep.assignment.clear();
+    for (std::size_t i = 0; i < cursor.size(); i++) {
+        if (cursor[i] >= 0) cachedStep.assignment.push_back({ static_cast<int>(i), cursor[i] });
+    }
+    TSPAlgorithm::subtoursFromSuccessors(cursor, cachedStep.subtours);
+    cachedStep.isFinalTour = cachedStep.subtours.size() == 1 && cachedStep.subtours[0].size() == cursor.size();
+    cachedStep.description = TSPAlgorithm::describeStep(cachedStep);
+    cachedIndex = index;
+    return cachedStep;
+}
+
+std::vector<TSPStep> StepHistory::toSteps() const {
+    std::vector<TSPStep> steps;
+    steps.reserve(size());
+    for (std::size_t i = 0; i < size(); i++) steps.push_back((*this)[i]);
+    return steps;
+}
+
+std::size_t StepHistory::bytes() const {
+    std::size_t total = deltas.capacity() * sizeof(Delta) +
+                        deltaStart.capacity() * sizeof(std::size_t) +
+                        iterations.capacity() * sizeof(int) +
+                        lastSuccessor.capacity() * sizeof(int);
+    for (const auto& k : keyframes) total += k.capacity() * sizeof(int);
+    return total;
+}
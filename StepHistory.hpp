@@ -0,0 +1,59 @@
+#ifndef STEPHISTORY_HPP
+#define STEPHISTORY_HPP
+
+#include "TSPAlgorithm.hpp"
+#include <vector>
+#include <cstddef>
+
+// Compact record of every patching iteration. Each step is the successor array
+// of the assignment; only every keyframeInterval-th step is stored in full,
+// the rest as edge diffs against the previous step. Reconstructed steps are
+// cached, so moving one step forward or back applies a single diff.
+class StepHistory {
+public:
+    explicit StepHistory(int keyframeInterval = 16);
+
+    void clear();
+
+    // Record the assignment of one iteration (successor[i] = city visited after i)
+    void push(const std::vector<int>& successor, int iteration);
+    void push(const TSPStep& step);
+
+    std::size_t size() const { return iterations.size(); }
+    bool empty() const { return iterations.empty(); }
+
+    // Reconstructed step; the reference stays valid until the next access
+    const TSPStep& operator[](std::size_t index) const;
+
+    // Successor array of a step, without building the full TSPStep
+    const std::vector<int>& successorAt(std::size_t index) const;
+
+    std::vector<TSPStep> toSteps() const;
+
+    // Approximate heap footprint of the stored history
+    std::size_t bytes() const;
+
+private:
+    struct Delta {
+        int city;
+        int oldNext;
+        int newNext;
+    };
+
+    void seek(std::size_t index) const;
+
+    int keyframeInterval;
+    std::vector<std::vector<int>> keyframes;  // Full state of steps 0, K, 2K, ...
+    std::vector<Delta> deltas;                // Changes of step s are deltas[deltaStart[s] .. deltaStart[s + 1])
+    std::vector<std::size_t> deltaStart;
+    std::vector<int> iterations;
+    std::vector<int> lastSuccessor;
+
+    // Reconstruction cursor and materialised step
+    mutable std::vector<int> cursor;
+    mutable std::size_t cursorIndex;
+    mutable TSPStep cachedStep;
+    mutable std::size_t cachedIndex;
+};
+
+#endif // STEPHISTORY_HPP
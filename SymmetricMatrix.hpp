@@ -0,0 +1,62 @@
+#ifndef SYMMETRICMATRIX_HPP
+#define SYMMETRICMATRIX_HPP
+
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+#include <utility>
+
+// Packed upper-triangular storage for symmetric n x n matrices (diagonal included).
+// Row i holds columns i..n-1 back to back, so element (i, j) with j >= i lives at
+// rowBase[i] + j; the per-row base keeps row scans to a single add per element.
+template<class T>
+class SymmetricMatrix {
+public:
+    SymmetricMatrix() : n(0) {}
+    explicit SymmetricMatrix(std::size_t size, const T& value = T()) { resize(size, value); }
+
+    void resize(std::size_t size, const T& value = T()) {
+        n = size;
+        rowBase.resize(n);
+        for (std::size_t i = 0; i < n; i++) {
+            rowBase[i] = i * n - i * (i + 1) / 2;
+        }
+        data.assign(n * (n + 1) / 2, value);
+    }
+
+    void clear() {
+        n = 0;
+        rowBase.clear();
+        data.clear();
+        data.shrink_to_fit();
+    }
+
+    std::size_t rows() const { return n; }
+    std::size_t columns() const { return n; }
+    std::size_t bytes() const { return data.size() * sizeof(T) + rowBase.size() * sizeof(std::size_t); }
+
+    std::size_t index(std::size_t i, std::size_t j) const {
+        if (j < i) std::swap(i, j);
+        return rowBase[i] + j;
+    }
+
+    T& operator()(std::size_t i, std::size_t j) { return data[index(i, j)]; }
+    const T& operator()(std::size_t i, std::size_t j) const { return data[index(i, j)]; }
+
+    // Contiguous columns i..n-1 of row i
+    const T* rowTail(std::size_t i) const { return data.data() + rowBase[i] + i; }
+    T* rowTail(std::size_t i) { return data.data() + rowBase[i] + i; }
+
+    // Gather the full row i into out[0..n)
+    void copyRow(std::size_t i, T* out) const {
+        for (std::size_t j = 0; j < i; j++) out[j] = data[rowBase[j] + i];
+        std::copy(rowTail(i), rowTail(i) + (n - i), out + i);
+    }
+
+private:
+    std::size_t n;
+    std::vector<std::size_t> rowBase;
+    std::vector<T> data;
+};
+
+#endif // SYMMETRICMATRIX_HPP
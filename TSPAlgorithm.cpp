@@ -1,196 +1,555 @@
 ﻿#include "TSPAlgorithm.hpp"
-#include "munkres-cpp/src/matrix.h"
-#include "munkres-cpp/src/munkres.h"
+#include "SolverWorkspace.hpp"
+#include "SolverPhases.hpp"
+#include "StepHistory.hpp"
+#include "SolveRecorder.hpp"
+#include "Logger.hpp"
 #include <cmath>
-#include <iostream>
 #include <limits>
 #include <algorithm>
+#include <filesystem>
 
 const double INF = std::numeric_limits<double>::max() / 2.0;
 
 // Build distance matrix from city coordinates
-void TSPAlgorithm::buildDistanceMatrix(const std::vector<City>& cities, 
-                                        Matrix<double>& costMatrix) {
+void SolverPhases::buildDistanceMatrix(const CityStore& cities, 
+                                        SymmetricMatrix<double>& distances) {
     int n = cities.size();
-    costMatrix.resize(n, n, 0.0);
+    distances.resize(n, 0.0);
     
+    // Use ORIGINAL coordinates for physical distance
+    const float* xs = cities.origXData();
+    const float* ys = cities.origYData();
+    
+    // Distances are symmetric, so only j >= i is computed and stored
     for (int i = 0; i < n; i++) {
-        for (int j = 0; j < n; j++) {
-            if (i == j) {
-                costMatrix(i, j) = INF;  // No self-loops
-            } else {
-                // Use ORIGINAL coordinates for physical distance
-                double dx = cities[i].orig_x - cities[j].orig_x;
-                double dy = cities[i].orig_y - cities[j].orig_y;
-                costMatrix(i, j) = std::sqrt(dx * dx + dy * dy);
-            }
+        double* row = distances.rowTail(i);
+        row[0] = INF;  // No self-loops
+        for (int j = i + 1; j < n; j++) {
+            double dx = xs[i] - xs[j];
+            double dy = ys[i] - ys[j];
+            row[j - i] = std::sqrt(dx * dx + dy * dy);
         }
     }
 }
 
-// Extract assignment from solved Munkres matrix
-std::vector<std::pair<int, int>> TSPAlgorithm::extractAssignment(const Matrix<double>& matrix) {
-    std::vector<std::pair<int, int>> assignment;
-    int n = matrix.rows();
+// Build the dense matrix; each distance is computed once and mirrored
+void SolverPhases::buildDistanceMatrix(const CityStore& cities, 
+                                        SquareMatrix<double>& distances) {
+    int n = cities.size();
+    distances.resize(n, 0.0);
+    
+    const float* xs = cities.origXData();
+    const float* ys = cities.origYData();
     
     for (int i = 0; i < n; i++) {
-        for (int j = 0; j < n; j++) {
-            // In Munkres output, assigned cells are marked with 0
-            if (matrix(i, j) == 0) {
-                assignment.push_back({i, j});
-                break;  // One assignment per row
-            }
+        double* row = distances.row(i);
+        row[i] = INF;  // No self-loops
+        for (int j = i + 1; j < n; j++) {
+            double dx = xs[i] - xs[j];
+            double dy = ys[i] - ys[j];
+            row[j] = std::sqrt(dx * dx + dy * dy);
+            distances(j, i) = row[j];
         }
     }
+}
+
+// Build the on-disk matrix row by row so writes stay sequential
+void SolverPhases::buildDistanceMatrix(const CityStore& cities, 
+                                        MappedMatrix& distances) {
+    const std::size_t n = cities.size();
+    const float* xs = cities.origXData();
+    const float* ys = cities.origYData();
     
-    return assignment;
+    for (std::size_t i = 0; i < n; i++) {
+        double* row = distances.row(i);
+        for (std::size_t j = 0; j < n; j++) {
+            double dx = xs[i] - xs[j];
+            double dy = ys[i] - ys[j];
+            row[j] = (i == j) ? INF : std::sqrt(dx * dx + dy * dy);
+        }
+        // Finished rows are flushed by the OS; drop them from our resident set
+        distances.releaseRows(i, i + 1);
+    }
 }
 
-// Detect all cycles/subtours in the assignment
-std::vector<std::vector<int>> TSPAlgorithm::findSubtours(
-    const std::vector<std::pair<int, int>>& assignment, int n) {
+namespace {
+
+// Cost rows as the backends see them: distances plus the directed forbidden
+// edges, which are kept sorted by source row
+template<class Storage>
+class PatchedCostRows : public CostRows {
+public:
+    PatchedCostRows(const Storage& distances, const std::vector<std::pair<int, int>>& forbidden)
+        : distances(distances), forbidden(forbidden) {}
     
-    std::vector<bool> visited(n, false);
-    std::vector<std::vector<int>> subtours;
+    int size() const override { return distances.rows(); }
     
-    // Build adjacency for quick lookup
-    std::vector<int> next(n, -1);
-    for (const auto& [from, to] : assignment) {
-        next[from] = to;
+    const double* row(int i, double* scratch) const override {
+        distances.copyRow(i, scratch);
+        auto it = std::lower_bound(forbidden.begin(), forbidden.end(), std::make_pair(i, -1));
+        for (; it != forbidden.end() && it->first == i; ++it) {
+            scratch[it->second] = INF;
+        }
+        return scratch;
     }
     
+private:
+    const Storage& distances;
+    const std::vector<std::pair<int, int>>& forbidden;
+};
+
+// Length of the closed tour given by a successor array
+double successorLength(const CityStore& cities, const std::vector<int>& successor) {
+    double total = 0.0;
+    const float* xs = cities.origXData();
+    const float* ys = cities.origYData();
+    for (size_t from = 0; from < successor.size(); from++) {
+        int to = successor[from];
+        double dx = xs[from] - xs[to];
+        double dy = ys[from] - ys[to];
+        total += std::sqrt(dx * dx + dy * dy);
+    }
+    return total;
+}
+
+}
+
+// Extract assignment from the backend's permutation
+void SolverPhases::extractAssignment(const AssignmentResult& result,
+                                     std::vector<std::pair<int, int>>& assignment) {
+    assignment.clear();
+    int n = result.rowToCol.size();
+    
+    for (int i = 0; i < n; i++) {
+        if (result.rowToCol[i] >= 0) {
+            assignment.push_back({i, result.rowToCol[i]});
+        }
+    }
+}
+
+// Detect all cycles/subtours in the assignment
+void SolverPhases::findSubtours(SolverWorkspace& ws, int n) {
+    SubtourList& subtours = ws.subtours;
+    subtours.clear();
+    ws.visited.assign(n, 0);
+    
+    // The backend's permutation is the successor array
+    const std::vector<int>& next = ws.assignmentResult.rowToCol;
+    
     // Find all cycles
     for (int start = 0; start < n; start++) {
-        if (visited[start]) continue;
+        if (ws.visited[start]) continue;
         
-        std::vector<int> cycle;
         int current = start;
         
         // Follow the chain until we return to start
-        while (!visited[current]) {
-            visited[current] = true;
-            cycle.push_back(current);
+        while (!ws.visited[current]) {
+            ws.visited[current] = 1;
+            subtours.nodes.push_back(current);
             current = next[current];
             
             if (current == -1) {
-                std::cerr << "ERROR: Broken assignment chain!" << std::endl;
+                TSP_LOG(LogLevel::Error, LogCategory::Subtour, "Broken assignment chain at city %d", start);
                 break;
             }
         }
         
-        if (!cycle.empty()) {
-            subtours.push_back(cycle);
+        if ((int)subtours.nodes.size() > subtours.starts.back()) {
+            subtours.starts.push_back(subtours.nodes.size());
         }
     }
-    
-    return subtours;
 }
 
-// Forbid edges in small subtours (set cost to infinity)
-void TSPAlgorithm::forbidSubtourEdges(Matrix<double>& costMatrix, 
-                                      const std::vector<std::vector<int>>& subtours,
+std::vector<std::vector<int>> SubtourList::toVectors() const {
+    std::vector<std::vector<int>> result(count());
+    for (size_t k = 0; k < count(); k++) {
+        result[k].assign(members(k), members(k) + size(k));
+    }
+    return result;
+}
+
+// Forbid edges in small subtours (recorded, applied as infinite cost)
+void SolverPhases::forbidSubtourEdges(std::vector<std::pair<int, int>>& forbidden, 
+                                      const SubtourList& subtours,
                                       int minSize) {
-    for (const auto& subtour : subtours) {
+    for (size_t k = 0; k < subtours.count(); k++) {
+        int size = subtours.size(k);
         // Only forbid edges in subtours smaller than the full tour
-        if (subtour.size() < minSize) {
+        if (size < minSize) {
             // Forbid the first edge in this subtour
+            const int* subtour = subtours.members(k);
             int from = subtour[0];
-            int to = subtour[1 % subtour.size()];
-            costMatrix(from, to) = INF;
-            
-            std::cout << "  Forbidding edge: " << from << " -> " << to 
-                      << " (subtour size: " << subtour.size() << ")" << std::endl;
+            int to = subtour[1 % size];
+            forbidden.push_back({from, to});
         }
     }
 }
+
+SolverWorkspace& SolverWorkspace::local() {
+    static thread_local SolverWorkspace workspace;
+    return workspace;
+}
+
+void SolverWorkspace::release() {
+    distances.clear();
+    denseDistances.clear();
+    mappedDistances.close();
+    std::vector<std::pair<int, int>>().swap(forbidden);
+    std::vector<std::pair<int, int>>().swap(assignment);
+    std::vector<int>().swap(raisedRows);
+    std::vector<std::pair<int, int>>().swap(newlyForbidden);
+    assignmentResult = AssignmentResult();
+    std::vector<char>().swap(visited);
+    subtours = SubtourList();
+}
+
+std::size_t SolverWorkspace::bytes() const {
+    std::size_t total = distances.bytes() + denseDistances.bytes() +
+           forbidden.capacity() * sizeof(std::pair<int, int>) +
+           newlyForbidden.capacity() * sizeof(std::pair<int, int>) +
+           assignment.capacity() * sizeof(std::pair<int, int>) +
+           raisedRows.capacity() * sizeof(int) +
+           (assignmentResult.rowToCol.capacity() + assignmentResult.colToRow.capacity()) * sizeof(int) +
+           (assignmentResult.u.capacity() + assignmentResult.v.capacity()) * sizeof(double) +
+           visited.capacity() +
+           (subtours.nodes.capacity() + subtours.starts.capacity()) * sizeof(int) +
+           hungarian.bytes();
+#if TSP_WITH_MUNKRES
+    total += munkres.bytes();
+#endif
+    return total;
+}
+
 // Main TSP solver using Hungarian + Subtour Patching
 std::vector<TSPStep> TSPAlgorithm::solveWithHungarian(const std::vector<City>& cities) {
-    std::vector<TSPStep> steps;
-    int n = cities.size();
+    return solveWithHungarian(CityStore(cities));
+}
+
+std::vector<TSPStep> TSPAlgorithm::solveWithHungarian(const CityStore& cities,
+                                                      const SolverOptions& options) {
+    return solveWithHungarian(cities, SolverWorkspace::local(), options);
+}
+
+std::vector<TSPStep> TSPAlgorithm::solveWithHungarian(const CityStore& cities, SolverWorkspace& ws,
+                                                      const SolverOptions& options) {
+    StepHistory history;
+    solveWithHungarian(cities, ws, history, options);
+    return history.toSteps();
+}
+
+void TSPAlgorithm::solveWithHungarian(const CityStore& cities, StepHistory& history,
+                                      const SolverOptions& options) {
+    solveWithHungarian(cities, SolverWorkspace::local(), history, options);
+}
+
+void TSPAlgorithm::solveWithHungarian(const CityStore& cities, SolverWorkspace& ws, StepHistory& history,
+                                      const SolverOptions& options) {
+    HistoryRecorder recorder(history);
+    solve(cities, recorder, ws, options);
+}
+
+// Headless fast path: nothing is recorded or logged per iteration
+SolveResult TSPAlgorithm::solveTour(const CityStore& cities, const SolverOptions& options) {
+    return solveTour(cities, SolverWorkspace::local(), options);
+}
+
+SolveResult TSPAlgorithm::solveTour(const CityStore& cities, SolverWorkspace& ws,
+                                    const SolverOptions& options) {
+    NullRecorder recorder;
+    return solve(cities, recorder, ws, options);
+}
+
+HungarianStepper::HungarianStepper(const CityStore& cities, const SolverOptions& options)
+    : HungarianStepper(cities, SolverWorkspace::local(), options) {}
+
+HungarianStepper::HungarianStepper(const CityStore& cities, SolverWorkspace& ws,
+                                   const SolverOptions& options)
+    : cities(cities), ws(ws), options(options), n(cities.size()), currentIteration(-1),
+      started(false), finished(false), tourFound(false), outOfCore(false), packed(false), outOfTime(false),
+      stepDetail(true), bytesAtStart(0) {}
+
+HungarianStepper::~HungarianStepper() {
+    finish();
+}
+
+const std::vector<int>& HungarianStepper::successor() const {
+    return ws.assignmentResult.rowToCol;
+}
+
+const std::vector<std::pair<int, int>>& HungarianStepper::assignment() const {
+    return ws.assignment;
+}
+
+const std::vector<std::pair<int, int>>& HungarianStepper::newlyForbidden() const {
+    return ws.newlyForbidden;
+}
+
+const SubtourList& HungarianStepper::subtours() const {
+    return ws.subtours;
+}
+
+const AssignmentResult& HungarianStepper::assignmentResult() const {
+    return ws.assignmentResult;
+}
+
+void HungarianStepper::start() {
+    started = true;
+    startTime = std::chrono::steady_clock::now();
+    stats.reset();
+    stats.cities = n;
+    stats.stepDetail = stepDetail;
+    if (stepDetail) stats.subtoursPerIteration.reserve(std::min(options.maxIterations, 1024));
+    bytesAtStart = ws.bytes();
+    ScopedPhaseTimer timer(stats, SolverPhase::Matrix);
     
+    // Build initial distance matrix; patching only ever adds forbidden edges on top
+    outOfCore = options.outOfCoreFor(n);
+    if (outOfCore && !options.engineFits(n)) {
+        // The front ends refuse this; anything else gets the engine that can run out of core
+        TSP_LOG(LogLevel::Warn, LogCategory::Solver,
+                "munkres-cpp needs the whole matrix in RAM, using the Hungarian backend out of core");
+        options.engine = AssignmentEngine::Hungarian;
+    }
+    if (outOfCore) {
+        std::string directory = options.scratchDirectory;
+        if (directory.empty()) {
+            std::error_code ec;
+            directory = std::filesystem::temp_directory_path(ec).string();
+        }
+        if (ws.mappedDistances.open(directory, n)) {
+            SolverPhases::buildDistanceMatrix(cities, ws.mappedDistances);
+        } else {
+            TSP_LOG(LogLevel::Warn, LogCategory::Matrix,
+                    "Could not map the distance matrix in %s, keeping it in memory", directory.c_str());
+            outOfCore = false;
+        }
+    }
+    // Packed rows are a strided gather, so they are only worth it when memory is tight
+    packed = !outOfCore && options.packedThreshold > 0 && n >= options.packedThreshold;
+    if (packed) {
+        SolverPhases::buildDistanceMatrix(cities, ws.distances);
+    } else if (!outOfCore) {
+        SolverPhases::buildDistanceMatrix(cities, ws.denseDistances);
+    }
+    ws.forbidden.clear();
+    ws.raisedRows.clear();
+    ws.newlyForbidden.clear();
+    
+#if !TSP_WITH_MUNKRES
+    if (options.engine == AssignmentEngine::Munkres) {
+        TSP_LOG(LogLevel::Warn, LogCategory::Solver, "Built without munkres-cpp, using the Hungarian backend");
+    }
+#endif
+}
+
+void HungarianStepper::finish() {
+    if (started && !finished) {
+        // The mapped file is per-solve; the in-memory buffers stay for the next one
+        ws.mappedDistances.close();
+        
+        stats.foundTour = tourFound;
+        if (tourFound) stats.tourLength = successorLength(cities, ws.assignmentResult.rowToCol);
+        stats.workspaceBytes = ws.bytes();
+        stats.workspaceGrowthBytes = stats.workspaceBytes > bytesAtStart ? stats.workspaceBytes - bytesAtStart : 0;
+    }
+    finished = true;
+}
+
+bool HungarianStepper::next() {
+    if (finished) return false;
     if (n < 2) {
-        std::cerr << "Need at least 2 cities for TSP!" << std::endl;
-        return steps;
+        TSP_LOG(LogLevel::Error, LogCategory::Solver, "Need at least 2 cities for TSP!");
+        finish();
+        return false;
     }
+    if (!started) start();
     
-    std::cout << "\n=== Starting Hungarian TSP Solver with " << n << " cities ===" << std::endl;
+    int iteration = currentIteration + 1;
+    if (iteration >= options.maxIterations) {
+        TSP_LOG(LogLevel::Warn, LogCategory::Solver, "Reached maximum iterations without finding tour!");
+        finish();
+        return false;
+    }
     
-    // Build initial cost matrix
-    Matrix<double> costMatrix;
-    buildDistanceMatrix(cities, costMatrix);
+    // Always finish the first assignment, so there are subtours to fall back on
+    if (options.timeLimit > 0.0 && iteration > 0 &&
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count() > options.timeLimit) {
+        TSP_LOG(LogLevel::Warn, LogCategory::Solver, "Time limit reached without finding tour!");
+        outOfTime = true;
+        finish();
+        return false;
+    }
     
-    std::cout << "Initial distance matrix built" << std::endl;
+    if (iteration > 0) {
+        ScopedPhaseTimer timer(stats, SolverPhase::Patch);
+        // Forbid edges in the previous subtours; each forbidden edge is its row's assigned edge
+        size_t firstNew = ws.forbidden.size();
+        SolverPhases::forbidSubtourEdges(ws.forbidden, ws.subtours, n);
+        ws.raisedRows.clear();
+        for (size_t k = firstNew; k < ws.forbidden.size(); k++) {
+            ws.raisedRows.push_back(ws.forbidden[k].first);
+        }
+        if (stepDetail) ws.newlyForbidden.assign(ws.forbidden.begin() + firstNew, ws.forbidden.end());
+        std::sort(ws.forbidden.begin(), ws.forbidden.end());
+    }
     
-    int iteration = 0;
-    const int MAX_ITERATIONS = 100;
+    PatchedCostRows<SquareMatrix<double>> denseCosts(ws.denseDistances, ws.forbidden);
+    PatchedCostRows<SymmetricMatrix<double>> packedCosts(ws.distances, ws.forbidden);
+    PatchedCostRows<MappedMatrix> mappedCosts(ws.mappedDistances, ws.forbidden);
+    const CostRows& costs = outOfCore ? static_cast<const CostRows&>(mappedCosts)
+                          : packed ? static_cast<const CostRows&>(packedCosts) : denseCosts;
+#if TSP_WITH_MUNKRES
+    AssignmentBackend& backend = (options.engine == AssignmentEngine::Munkres)
+        ? static_cast<AssignmentBackend&>(ws.munkres) : ws.hungarian;
+#else
+    AssignmentBackend& backend = ws.hungarian;
+#endif
     
-    while (iteration < MAX_ITERATIONS) {
-        std::cout << "\n--- Iteration " << iteration << " ---" << std::endl;
-        
-        // Make a copy for this iteration (Munkres modifies in-place)
-        Matrix<double> matrixCopy = costMatrix;
-        
-        // Apply Hungarian algorithm
-        Munkres<double> solver;
-        solver.solve(matrixCopy);
-        
-        // Extract assignment
-        auto assignment = extractAssignment(matrixCopy);
-        
-        std::cout << "Assignment found: " << assignment.size() << " edges" << std::endl;
-        
-        // Detect subtours
-        auto subtours = findSubtours(assignment, n);
-        
-        std::cout << "Detected " << subtours.size() << " subtour(s):" << std::endl;
-        for (size_t i = 0; i < subtours.size(); i++) {
-            std::cout << "  Subtour " << i << " (size " << subtours[i].size() << "): ";
-            for (int city : subtours[i]) {
-                std::cout << city << " ";
-            }
-            std::cout << std::endl;
-        }
-        
-        // Create step record
-        TSPStep step;
-        step.assignment = assignment;
-        step.subtours = subtours;
-        step.iteration = iteration;
-        step.isFinalTour = (subtours.size() == 1 && subtours[0].size() == n);
-        
-        if (step.isFinalTour) {
-            step.description = "Final Tour Found! (Single Hamiltonian Cycle)";
-            std::cout << "SUCCESS: Found complete tour in iteration " << iteration << std::endl;
+    // Apply Hungarian algorithm (later iterations warm-start from the previous duals)
+    {
+        ScopedPhaseTimer timer(stats, SolverPhase::Assign);
+        if (iteration == 0) {
+            backend.solve(costs, ws.assignmentResult);
         } else {
-            step.description = "Iteration " + std::to_string(iteration) + 
-                              ": Found " + std::to_string(subtours.size()) + " subtours";
+            backend.resolve(costs, ws.raisedRows, ws.assignmentResult);
         }
+    }
+    
+    // Extract assignment
+    if (stepDetail) {
+        ScopedPhaseTimer timer(stats, SolverPhase::Extract);
+        SolverPhases::extractAssignment(ws.assignmentResult, ws.assignment);
+    }
+    
+    // Detect subtours
+    {
+        ScopedPhaseTimer timer(stats, SolverPhase::Subtour);
+        SolverPhases::findSubtours(ws, n);
+    }
+    const SubtourList& subtours = ws.subtours;
+    
+    currentIteration = iteration;
+    stats.iterations = iteration + 1;
+    if (stepDetail) stats.subtoursPerIteration.push_back(subtours.count());
+    stats.lastSubtours = static_cast<int>(subtours.count());
+    stats.maxSubtours = std::max(stats.maxSubtours, stats.lastSubtours);
+    if (iteration == 0) stats.firstSubtours = stats.lastSubtours;
+    
+    // Check if we're done
+    if (subtours.count() == 1 && (int)subtours.size(0) == n) {
+        tourFound = true;
+        finish();
+    }
+    
+    return true;
+}
+
+void TSPAlgorithm::subtoursFromSuccessors(const std::vector<int>& successor,
+                                          std::vector<std::vector<int>>& subtours) {
+    int n = successor.size();
+    subtours.clear();
+    std::vector<char> visited(n, 0);
+    
+    for (int start = 0; start < n; start++) {
+        if (visited[start]) continue;
         
-        steps.push_back(step);
-        
-        // Check if we're done
-        if (step.isFinalTour) {
-            double tourLength = calculateTourLength(cities, assignment);
-            std::cout << "Tour length: " << tourLength << std::endl;
-            break;
+        std::vector<int> cycle;
+        int current = start;
+        while (current != -1 && !visited[current]) {
+            visited[current] = 1;
+            cycle.push_back(current);
+            current = successor[current];
         }
+        subtours.push_back(std::move(cycle));
+    }
+}
+
+void TSPAlgorithm::mergeSubtours(const CityStore& cities, const SubtourList& subtours,
+                                 std::vector<int>& tour) {
+    tour.clear();
+    if (subtours.count() == 0) return;
+    
+    // Largest subtour first, so most of the tour is kept as the solver built it
+    std::vector<size_t> order(subtours.count());
+    for (size_t k = 0; k < order.size(); k++) order[k] = k;
+    std::sort(order.begin(), order.end(),
+              [&](size_t a, size_t b) { return subtours.size(a) > subtours.size(b); });
+    
+    const float* xs = cities.origXData();
+    const float* ys = cities.origYData();
+    auto dist = [&](int a, int b) {
+        double dx = xs[a] - xs[b];
+        double dy = ys[a] - ys[b];
+        return std::sqrt(dx * dx + dy * dy);
+    };
+    
+    tour.assign(subtours.members(order[0]), subtours.members(order[0]) + subtours.size(order[0]));
+    std::vector<int> merged;
+    for (size_t o = 1; o < order.size(); o++) {
+        const int* sub = subtours.members(order[o]);
+        const size_t m = subtours.size(order[o]);
         
-        // Forbid edges in subtours and continue
-        forbidSubtourEdges(costMatrix, subtours, n);
+        // Replace tour edge (a, b) and subtour edge (c, d) by (a, d) + (c, b),
+        // or by (a, c) + (d, b) with the subtour walked backwards
+        double bestDelta = INF;
+        size_t bestI = 0, bestK = 0;
+        bool bestReversed = false;
+        for (size_t i = 0; i < tour.size(); i++) {
+            int a = tour[i];
+            int b = tour[(i + 1) % tour.size()];
+            double ab = dist(a, b);
+            for (size_t k = 0; k < m; k++) {
+                int c = sub[k];
+                int d = sub[(k + 1) % m];
+                double cd = dist(c, d);
+                double forward = dist(a, d) + dist(c, b) - ab - cd;
+                double backward = dist(a, c) + dist(d, b) - ab - cd;
+                if (forward < bestDelta) {
+                    bestDelta = forward; bestI = i; bestK = k; bestReversed = false;
+                }
+                if (backward < bestDelta) {
+                    bestDelta = backward; bestI = i; bestK = k; bestReversed = true;
+                }
+            }
+        }
         
-        iteration++;
+        merged.clear();
+        merged.insert(merged.end(), tour.begin(), tour.begin() + bestI + 1);
+        for (size_t s = 0; s < m; s++) {
+            // Forward: d, ..., c; backward: c, ..., d
+            size_t k = bestReversed ? (bestK + m - s) % m : (bestK + 1 + s) % m;
+            merged.push_back(sub[k]);
+        }
+        merged.insert(merged.end(), tour.begin() + bestI + 1, tour.end());
+        tour.swap(merged);
     }
-    
-    if (iteration >= MAX_ITERATIONS) {
-        std::cerr << "WARNING: Reached maximum iterations without finding tour!" << std::endl;
+}
+
+std::string TSPAlgorithm::describeStep(const TSPStep& step) {
+    if (step.isFinalTour) {
+        return "Final Tour Found! (Single Hamiltonian Cycle)";
     }
+    return "Iteration " + std::to_string(step.iteration) + 
+           ": Found " + std::to_string(step.subtours.size()) + " subtours";
+}
+
+// Calculate total tour length
+double TSPAlgorithm::calculateTourLength(const CityStore& cities, 
+                                         const std::vector<std::pair<int, int>>& assignment) {
+    double total = 0.0;
+    const float* xs = cities.origXData();
+    const float* ys = cities.origYData();
     
-    std::cout << "\n=== Solver finished with " << steps.size() << " steps ===" << std::endl;
+    for (const auto& [from, to] : assignment) {
+        double dx = xs[from] - xs[to];
+        double dy = ys[from] - ys[to];
+        total += std::sqrt(dx * dx + dy * dy);
+    }
     
-    return steps;
+    return total;
 }
 
-// Calculate total tour length
 double TSPAlgorithm::calculateTourLength(const std::vector<City>& cities, 
                                          const std::vector<std::pair<int, int>>& assignment) {
     double total = 0.0;
@@ -203,3 +562,25 @@ double TSPAlgorithm::calculateTourLength(const std::vector<City>& cities,
     
     return total;
 }
+
+double TSPAlgorithm::calculateTourLength(const CityStore& cities, const std::vector<int>& tour) {
+    double total = 0.0;
+    const float* xs = cities.origXData();
+    const float* ys = cities.origYData();
+    
+    for (size_t i = 0; i < tour.size(); i++) {
+        int from = tour[i];
+        int to = tour[(i + 1) % tour.size()];
+        double dx = xs[from] - xs[to];
+        double dy = ys[from] - ys[to];
+        total += std::sqrt(dx * dx + dy * dy);
+    }
+    
+    return total;
+}
+
+// Only the two recorders the library itself uses are instantiated here
+template SolveResult TSPAlgorithm::solve<NullRecorder>(const CityStore&, NullRecorder&,
+                                                       SolverWorkspace&, const SolverOptions&);
+template SolveResult TSPAlgorithm::solve<HistoryRecorder>(const CityStore&, HistoryRecorder&,
+                                                          SolverWorkspace&, const SolverOptions&);
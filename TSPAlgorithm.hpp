@@ -2,12 +2,34 @@
 #define TSPALGORITHM_HPP
 
 #include "City.hpp"
+#include "CityStore.hpp"
+#include "SymmetricMatrix.hpp"
+#include "SquareMatrix.hpp"
+#include "MappedMatrix.hpp"
+#include "SolverMetrics.hpp"
 #include <vector>
 #include <string>
 #include <utility>
+#include <chrono>
 
-// Forward declaration for Matrix template
-template<class T> class Matrix;
+// Forward declarations
+struct SolverWorkspace;
+struct AssignmentResult;
+class StepHistory;
+
+// Subtours stored flat: members of subtour k are nodes[starts[k] .. starts[k + 1])
+struct SubtourList {
+    std::vector<int> nodes;
+    std::vector<int> starts;
+    
+    SubtourList() : starts(1, 0) {}
+    
+    size_t count() const { return starts.size() - 1; }
+    size_t size(size_t k) const { return starts[k + 1] - starts[k]; }
+    const int* members(size_t k) const { return nodes.data() + starts[k]; }
+    void clear() { nodes.clear(); starts.assign(1, 0); }
+    std::vector<std::vector<int>> toVectors() const;
+};
 
 // Structure to hold one step in the TSP solving process
 struct TSPStep {
@@ -20,31 +42,151 @@ struct TSPStep {
     TSPStep() : iteration(0), isFinalTour(false) {}
 };
 
+// Which assignment solver drives the patching loop
+enum class AssignmentEngine {
+    Hungarian,  // Built-in shortest augmenting path with duals and warm start
+    Munkres     // munkres-cpp
+};
+
+struct SolverOptions {
+    AssignmentEngine engine;
+    int maxIterations;
+    double timeLimit;            // Wall-clock seconds for the patching loop; 0 means no limit
+    int packedThreshold;         // From this many cities the in-memory matrix is packed (half the
+                                 // memory, slower row reads); 0 never
+    int outOfCoreThreshold;      // From this many cities the distance matrix is a mapped file; 0 never
+    std::string scratchDirectory;  // Where that file goes; empty is the system temp directory,
+                                   // which may be RAM-backed (tmpfs) and defeat the purpose
+    
+    SolverOptions() : engine(AssignmentEngine::Hungarian), maxIterations(100), timeLimit(0.0),
+                      packedThreshold(10000), outOfCoreThreshold(50000) {}
+    
+    bool outOfCoreFor(int cities) const { return outOfCoreThreshold > 0 && cities >= outOfCoreThreshold; }
+    // munkres-cpp copies every cost into its own dense n x n matrix, which is
+    // exactly the memory an out-of-core solve cannot have
+    bool engineFits(int cities) const { return engine != AssignmentEngine::Munkres || !outOfCoreFor(cities); }
+};
+
+// Outcome of a solve, independent of what was recorded along the way
+struct SolveResult {
+    std::vector<int> tour;  // City order of the tour; if patching stopped early, its subtours spliced together
+    double length;
+    int iterations;
+    bool foundTour;         // Patching converged to a single tour
+    bool timedOut;          // Stopped by SolverOptions::timeLimit
+    SolverMetrics metrics;
+    
+    SolveResult() : length(0.0), iterations(0), foundTour(false), timedOut(false) {}
+};
+
 class TSPAlgorithm {
 public:
     // Main solving function - returns all steps for animation
+    static std::vector<TSPStep> solveWithHungarian(const CityStore& cities,
+                                                   const SolverOptions& options = SolverOptions());
     static std::vector<TSPStep> solveWithHungarian(const std::vector<City>& cities);
     
+    // Same, reusing the given workspace's buffers instead of the calling thread's pool
+    static std::vector<TSPStep> solveWithHungarian(const CityStore& cities, SolverWorkspace& ws,
+                                                   const SolverOptions& options = SolverOptions());
+    
+    // Final tour only: no per-iteration history, strings or logging
+    static SolveResult solveTour(const CityStore& cities, const SolverOptions& options = SolverOptions());
+    static SolveResult solveTour(const CityStore& cities, SolverWorkspace& ws,
+                                 const SolverOptions& options = SolverOptions());
+    
+    // Policy-based solve; the recorder (see SolveRecorder.hpp, where this is
+    // defined) decides what is kept or printed per iteration
+    template<class Recorder>
+    static SolveResult solve(const CityStore& cities, Recorder& recorder, SolverWorkspace& ws,
+                             const SolverOptions& options = SolverOptions());
+    
+    // Record the steps into a compact delta-encoded history instead
+    static void solveWithHungarian(const CityStore& cities, StepHistory& history,
+                                   const SolverOptions& options = SolverOptions());
+    static void solveWithHungarian(const CityStore& cities, SolverWorkspace& ws, StepHistory& history,
+                                   const SolverOptions& options = SolverOptions());
+    
+    // Split a successor array into its cycles
+    static void subtoursFromSuccessors(const std::vector<int>& successor,
+                                       std::vector<std::vector<int>>& subtours);
+    
+    // Splice subtours into one tour (Karp patching): each subtour joins the tour
+    // through the cheapest exchange of one tour edge and one subtour edge
+    static void mergeSubtours(const CityStore& cities, const SubtourList& subtours,
+                              std::vector<int>& tour);
+    
+    // Human readable description of a step
+    static std::string describeStep(const TSPStep& step);
+    
     // Get tour length for a given assignment
+    static double calculateTourLength(const CityStore& cities, 
+                                      const std::vector<std::pair<int, int>>& assignment);
     static double calculateTourLength(const std::vector<City>& cities, 
                                       const std::vector<std::pair<int, int>>& assignment);
+    
+    // Length of a closed tour given as a city order
+    static double calculateTourLength(const CityStore& cities, const std::vector<int>& tour);
+};
 
-private:
-    // Build distance matrix from cities
-    static void buildDistanceMatrix(const std::vector<City>& cities, 
-                                     Matrix<double>& costMatrix);
+// Resumable Hungarian + subtour patching solve. Each next() runs exactly one
+// iteration, so callers can pull steps on demand instead of paying for the
+// whole run up front. The workspace must not be shared with another live solve.
+class HungarianStepper {
+public:
+    HungarianStepper(const CityStore& cities, const SolverOptions& options = SolverOptions());
+    HungarianStepper(const CityStore& cities, SolverWorkspace& ws,
+                     const SolverOptions& options = SolverOptions());
+    ~HungarianStepper();
+    HungarianStepper(const HungarianStepper&) = delete;
+    HungarianStepper& operator=(const HungarianStepper&) = delete;
+    
+    // Without step detail (on by default) the stepper skips the work only
+    // observers need: the assignment pairs, newlyForbidden() and the
+    // per-iteration subtour counts in metrics(). Set before the first next().
+    void setStepDetail(bool on) { stepDetail = on; }
+    
+    // Compute the next step; returns false once the solve has finished
+    bool next();
     
-    // Extract assignment from solved matrix (elements marked as 0)
-    static std::vector<std::pair<int, int>> extractAssignment(const Matrix<double>& matrix);
+    bool done() const { return finished; }
+    bool foundTour() const { return tourFound; }
+    bool timedOut() const { return outOfTime; }
     
-    // Detect all subtours in the assignment
-    static std::vector<std::vector<int>> findSubtours(const std::vector<std::pair<int, int>>& assignment, 
-                                                       int n);
+    // State of the most recent step
+    int iteration() const { return currentIteration; }
+    int cityCount() const { return n; }
+    bool usesOutOfCore() const { return outOfCore; }
+    bool usesPackedMatrix() const { return packed; }
+    const CityStore& cityStore() const { return cities; }
+    const std::vector<int>& successor() const;
+    const std::vector<std::pair<int, int>>& assignment() const;       // Needs step detail
+    const SubtourList& subtours() const;
+    const std::vector<std::pair<int, int>>& newlyForbidden() const;  // Edges forbidden before this step; needs step detail
+    const AssignmentResult& assignmentResult() const;  // Including the duals, when the backend has them
+    
+    // Phase timings and counters so far
+    const SolverMetrics& metrics() const { return stats; }
+    
+private:
+    void start();
+    void finish();
     
-    // Forbid edges in subtours by setting their cost to infinity
-    static void forbidSubtourEdges(Matrix<double>& costMatrix, 
-                                   const std::vector<std::vector<int>>& subtours,
-                                   int minSize);
+    const CityStore& cities;
+    SolverWorkspace& ws;
+    SolverOptions options;
+    int n;
+    int currentIteration;
+    bool started;
+    bool finished;
+    bool tourFound;
+    bool outOfCore;
+    bool packed;
+    bool outOfTime;
+    bool stepDetail;
+    std::chrono::steady_clock::time_point startTime;
+    SolverMetrics stats;
+    std::size_t bytesAtStart;
 };
 
 #endif // TSPALGORITHM_HPP
@@ -0,0 +1,63 @@
+#include "ThreadPool.hpp"
+#include <algorithm>
+
+ThreadPool::ThreadPool(unsigned threads, std::size_t maxQueued)
+    : maxQueued(maxQueued), active(0), stopping(false) {
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    workers.reserve(threads);
+    for (unsigned t = 0; t < threads; t++) {
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    taskReady.notify_all();
+    for (std::thread& worker : workers) worker.join();
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (maxQueued > 0) {
+        spaceReady.wait(lock, [this] { return queue.size() < maxQueued; });
+    }
+    queue.push_back(std::move(task));
+    lock.unlock();
+    taskReady.notify_one();
+}
+
+void ThreadPool::wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    idle.wait(lock, [this] { return queue.empty() && active == 0; });
+}
+
+void ThreadPool::workerLoop() {
+    for (;;) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            taskReady.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (queue.empty()) return;  // Stopping and drained
+            task = std::move(queue.front());
+            queue.pop_front();
+            active++;
+        }
+        spaceReady.notify_one();
+
+        // Tasks report their own errors; an exception that still escapes must
+        // not take the process down or leave wait() blocked on this task
+        try {
+            task();
+        } catch (...) {
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            active--;
+            if (queue.empty() && active == 0) idle.notify_all();
+        }
+    }
+}
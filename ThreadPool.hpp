@@ -0,0 +1,45 @@
+#ifndef THREADPOOL_HPP
+#define THREADPOOL_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed-size worker pool. Workers live as long as the pool, so their
+// thread_local solver workspaces (SolverWorkspace::local) stay warm across jobs.
+// With a queue bound, submit() blocks the producer instead of buffering
+// an unbounded input stream in memory.
+class ThreadPool {
+public:
+    // threads == 0 uses every core; maxQueued == 0 means unbounded
+    explicit ThreadPool(unsigned threads = 0, std::size_t maxQueued = 0);
+    ~ThreadPool();  // Runs everything already queued, then joins
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void submit(std::function<void()> task);
+
+    // Block until every submitted task has finished
+    void wait();
+
+    unsigned size() const { return static_cast<unsigned>(workers.size()); }
+
+private:
+    void workerLoop();
+
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> queue;
+    std::size_t maxQueued;
+    std::size_t active;
+    bool stopping;
+    std::mutex mutex;
+    std::condition_variable taskReady;   // Workers: queue non-empty or stopping
+    std::condition_variable spaceReady;  // Producers: queue below its bound
+    std::condition_variable idle;        // wait(): queue empty and nothing running
+};
+
+#endif // THREADPOOL_HPP
@@ -0,0 +1,131 @@
+#include "TourPyramid.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+namespace {
+    const float FINEST_FRACTION = 1.0f / 65536.0f;  // First tolerance, relative to the tour's extent
+    const std::size_t COARSEST_VERTICES = 16;
+    const float MIN_REDUCTION = 0.75f;  // A level must drop a quarter of the previous one's vertices
+
+    // Distance from p to the segment a-b
+    float segmentDistance(float px, float py, float ax, float ay, float bx, float by) {
+        float dx = bx - ax, dy = by - ay;
+        float lengthSq = dx * dx + dy * dy;
+        float t = lengthSq > 0.0f ? std::clamp(((px - ax) * dx + (py - ay) * dy) / lengthSq, 0.0f, 1.0f) : 0.0f;
+        float ex = ax + t * dx - px, ey = ay + t * dy - py;
+        return std::sqrt(ex * ex + ey * ey);
+    }
+}
+
+void TourPyramid::build(const std::vector<float>& positions, const std::vector<int>& tour) {
+    if (!levels.empty() && tour == sourceTour) return;
+    clear();
+    const std::size_t n = tour.size();
+    if (n <= COARSEST_VERTICES) return;
+    sourceTour = tour;
+
+    auto px = [&](std::size_t k) { return positions[2 * tour[k % n]]; };
+    auto py = [&](std::size_t k) { return positions[2 * tour[k % n] + 1]; };
+
+    // Anchor the closed tour at its first vertex and the vertex farthest from it
+    std::size_t far = 0;
+    float farDistance = -1.0f;
+    float minX = px(0), maxX = px(0), minY = py(0), maxY = py(0);
+    for (std::size_t k = 0; k < n; k++) {
+        float dx = px(k) - px(0), dy = py(k) - py(0);
+        if (dx * dx + dy * dy > farDistance) {
+            farDistance = dx * dx + dy * dy;
+            far = k;
+        }
+        minX = std::min(minX, px(k));
+        maxX = std::max(maxX, px(k));
+        minY = std::min(minY, py(k));
+        maxY = std::max(maxY, py(k));
+    }
+
+    // Douglas-Peucker over both halves; a vertex's rank is the deviation at
+    // which it split its interval, capped by the interval's ends so that a
+    // vertex never outranks the ones it depends on. Index n is vertex 0 again.
+    const float INF = std::numeric_limits<float>::infinity();
+    std::vector<float> rank(n + 1, 0.0f);
+    rank[0] = rank[n] = rank[far] = INF;
+    std::vector<std::pair<std::size_t, std::size_t>> stack{{0, far}, {far, n}};
+    while (!stack.empty()) {
+        auto [i, j] = stack.back();
+        stack.pop_back();
+        if (j - i < 2) continue;
+
+        std::size_t split = i + 1;
+        float deviation = -1.0f;
+        for (std::size_t k = i + 1; k < j; k++) {
+            float d = segmentDistance(px(k), py(k), px(i), py(i), px(j), py(j));
+            if (d > deviation) {
+                deviation = d;
+                split = k;
+            }
+        }
+        rank[split] = std::min(deviation, std::min(rank[i], rank[j]));
+        stack.push_back({i, split});
+        stack.push_back({split, j});
+    }
+
+    // Doubling tolerances from a tiny fraction of the extent until a handful of vertices is left
+    float extent = std::max(maxX - minX, maxY - minY);
+    std::size_t previous = n;
+    for (float tolerance = std::max(extent * FINEST_FRACTION, 1e-6f); previous > COARSEST_VERTICES && tolerance < 2.0f * extent; tolerance *= 2.0f) {
+        std::size_t kept = 0;
+        for (std::size_t k = 0; k < n; k++) {
+            if (rank[k] > tolerance) kept++;
+        }
+        if (kept > previous * MIN_REDUCTION) {
+            // Too close to the level before; only worth keeping as a tolerance bump
+            if (!levels.empty() && kept == levels.back().vertices.size()) levels.back().tolerance = tolerance;
+            continue;
+        }
+
+        Level level{tolerance, {}, Quadtree(), false};
+        level.vertices.reserve(kept);
+        for (std::size_t k = 0; k < n; k++) {
+            if (rank[k] > tolerance) level.vertices.push_back(static_cast<std::uint32_t>(tour[k]));
+        }
+        levels.push_back(std::move(level));
+        previous = kept;
+    }
+}
+
+void TourPyramid::clear() {
+    sourceTour.clear();
+    levels.clear();
+}
+
+std::size_t TourPyramid::pick(float maxError) const {
+    std::size_t chosen = 0;
+    for (std::size_t k = 0; k < levels.size() && levels[k].tolerance <= maxError; k++) {
+        chosen = k + 1;
+    }
+    return chosen;
+}
+
+void TourPyramid::query(std::size_t level, const std::vector<float>& positions, const Box& area, std::vector<std::uint32_t>& out) {
+    Level& current = levels[level - 1];
+    const std::vector<std::uint32_t>& v = current.vertices;
+    if (!current.indexed) {
+        std::vector<Box> boxes(v.size());
+        for (std::size_t s = 0; s < v.size(); s++) {
+            std::uint32_t a = v[s], b = v[(s + 1) % v.size()];
+            boxes[s] = {std::min(positions[2 * a], positions[2 * b]), std::min(positions[2 * a + 1], positions[2 * b + 1]),
+                        std::max(positions[2 * a], positions[2 * b]), std::max(positions[2 * a + 1], positions[2 * b + 1])};
+        }
+        current.segments.build(std::move(boxes));
+        current.indexed = true;
+    }
+
+    hits.clear();
+    current.segments.query(area, hits);
+    for (std::uint32_t s : hits) {
+        out.push_back(v[s]);
+        out.push_back(v[(s + 1) % v.size()]);
+    }
+}
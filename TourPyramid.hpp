@@ -0,0 +1,44 @@
+#ifndef TOURPYRAMID_HPP
+#define TOURPYRAMID_HPP
+
+#include "Quadtree.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Multi-resolution copies of a closed tour for drawing. One Douglas-Peucker
+// pass ranks every vertex by the error its removal would cause (clamped so
+// the levels nest); level k keeps the vertices ranked above its tolerance,
+// and tolerances double from level to level. The renderer picks the coarsest
+// level whose error is still under a pixel. Level 0 is the full tour, which
+// the caller draws itself.
+class TourPyramid {
+public:
+    // Rank and split the tour; a no-op when it is the tour already built
+    void build(const std::vector<float>& positions, const std::vector<int>& tour);
+    void clear();
+
+    bool empty() const { return levels.empty(); }
+    std::size_t levelCount() const { return levels.size() + 1; }
+
+    // Coarsest level whose tolerance is at most maxError world units
+    std::size_t pick(float maxError) const;
+
+    // Append the segments of a level (>= 1) touching area, as pairs of city
+    // indices; positions must be the ones the pyramid was built from
+    void query(std::size_t level, const std::vector<float>& positions, const Box& area, std::vector<std::uint32_t>& out);
+
+private:
+    struct Level {
+        float tolerance;
+        std::vector<std::uint32_t> vertices;  // Kept cities in tour order; the polyline closes
+        Quadtree segments;                    // Built on first query
+        bool indexed;
+    };
+
+    std::vector<int> sourceTour;
+    std::vector<std::uint32_t> hits;  // Query scratch
+    std::vector<Level> levels;
+};
+
+#endif // TOURPYRAMID_HPP
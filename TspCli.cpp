@@ -0,0 +1,379 @@
+// Headless command-line front end for the solver (no GLUT or OpenGL).
+//
+//   tsp_cli solve <input> [--engine hungarian|munkres] [--time-limit SECONDS]
+//                         [--max-iterations N] [--out FILE] [--metrics-format json|prometheus]
+//   tsp_cli batch <directory | -> [--threads N] [--engine ...] [--time-limit SECONDS]
+//                                 [--max-iterations N] [--out FILE]
+//
+// Both take --scratch-dir DIR and --out-of-core-threshold N: instances of at
+// least N cities (default 50000, 0 never) keep their distance matrix in a
+// mapped file in DIR (default: the system temp directory, which is often
+// tmpfs and so no better than RAM). Below that, --packed-threshold N (default
+// 10000, 0 never) switches the in-memory matrix to packed triangular storage,
+// half the memory for slower row reads.
+//
+// solve: <input> is a JSON city list, a TSPLIB .tsp file, or a plain "x,y" / "x y"
+// text file. The result is written as JSON to FILE, or to stdout; diagnostics
+// go to stderr. If the patching loop runs out of time or iterations, the
+// remaining subtours are spliced into a tour so there is always an answer.
+// --max-iterations defaults to SolverOptions' 100, the same limit tspd and the
+// visualiser use. Fewer than 2 cities is an error.
+// With --metrics-format prometheus the solver metrics leave the JSON and stdout
+// carries them in the Prometheus text format instead (e.g. for node_exporter's
+// textfile collector), so the result itself needs --out.
+//
+// batch: every *.json file in the directory, or every line of a JSONL stream on
+// stdin ("-"), is one job: {"id": ..., "cities": [{"x": .., "y": ..}, ...]} or a
+// bare city array. Optional per-job "time_limit", "max_iterations" and "engine"
+// override the command line. Jobs run on a thread pool and one JSON line per job
+// is written as each finishes (completion order, not input order).
+#include "TSPAlgorithm.hpp"
+#include "CityStore.hpp"
+#include "Tsplib.hpp"
+#include "ThreadPool.hpp"
+#include "json.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+using json = nlohmann::json;
+
+namespace {
+
+struct CliOptions {
+    std::string mode;
+    std::string input;
+    std::string outFile;
+    SolverOptions solver;
+    unsigned threads = 0;  // 0: every core
+    bool prometheus = false;  // Solve mode: metrics in the Prometheus text format on stdout
+};
+
+void printUsage() {
+    std::cerr << "Usage: tsp_cli solve <input> [--engine hungarian|munkres] [--time-limit SECONDS]\n"
+              << "                             [--max-iterations N] [--out FILE] [--metrics-format json|prometheus]\n"
+              << "       tsp_cli batch <directory | -> [--threads N] [--engine hungarian|munkres]\n"
+              << "                                     [--time-limit SECONDS] [--max-iterations N] [--out FILE]\n"
+              << "       common: [--scratch-dir DIR] [--out-of-core-threshold N] [--packed-threshold N]\n"
+              << "       --max-iterations defaults to " << SolverOptions().maxIterations
+              << std::endl;
+}
+
+bool endsWith(const std::string& s, const std::string& suffix) {
+    return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+// An engine that is not compiled in is an error, not a silent substitution
+bool parseEngine(const std::string& value, AssignmentEngine& engine, std::string& error) {
+    if (value == "hungarian") {
+        engine = AssignmentEngine::Hungarian;
+    } else if (value == "munkres") {
+#if TSP_WITH_MUNKRES
+        engine = AssignmentEngine::Munkres;
+#else
+        error = "engine munkres is not available (built without munkres-cpp)";
+        return false;
+#endif
+    } else {
+        error = "unknown engine " + value;
+        return false;
+    }
+    return true;
+}
+
+// Refused up front rather than left to the solver's fallback, so the reported engine is the one used
+bool checkEngineFits(const SolverOptions& solver, std::size_t cities, std::string& error) {
+    if (solver.engineFits(static_cast<int>(cities))) return true;
+    error = "engine munkres cannot run out of core (" + std::to_string(cities) + " cities, threshold " +
+            std::to_string(solver.outOfCoreThreshold) + "); use hungarian or raise --out-of-core-threshold";
+    return false;
+}
+
+const char* engineName(AssignmentEngine engine) {
+    return engine == AssignmentEngine::Munkres ? "munkres" : "hungarian";
+}
+
+bool parseArgs(int argc, char** argv, CliOptions& options) {
+    if (argc < 3) return false;
+    options.mode = argv[1];
+    if (options.mode != "solve" && options.mode != "batch") return false;
+    options.input = argv[2];
+
+    for (int i = 3; i < argc; i++) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << std::endl;
+            return false;
+        }
+        std::string value = argv[++i];
+        if (arg == "--engine") {
+            std::string error;
+            if (!parseEngine(value, options.solver.engine, error)) {
+                std::cerr << "Error: " << error << std::endl;
+                return false;
+            }
+        } else if (arg == "--time-limit") {
+            options.solver.timeLimit = std::atof(value.c_str());
+        } else if (arg == "--max-iterations") {
+            options.solver.maxIterations = std::atoi(value.c_str());
+        } else if (arg == "--threads") {
+            options.threads = static_cast<unsigned>(std::atoi(value.c_str()));
+        } else if (arg == "--out") {
+            options.outFile = value;
+        } else if (arg == "--metrics-format") {
+            if (value != "json" && value != "prometheus") {
+                std::cerr << "Error: unknown metrics format " << value << std::endl;
+                return false;
+            }
+            options.prometheus = value == "prometheus";
+        } else if (arg == "--scratch-dir") {
+            options.solver.scratchDirectory = value;
+        } else if (arg == "--out-of-core-threshold") {
+            options.solver.outOfCoreThreshold = std::atoi(value.c_str());
+        } else if (arg == "--packed-threshold") {
+            options.solver.packedThreshold = std::atoi(value.c_str());
+        } else {
+            std::cerr << "Unknown option " << arg << std::endl;
+            return false;
+        }
+    }
+    if (options.prometheus && (options.mode != "solve" || options.outFile.empty())) {
+        std::cerr << "Error: --metrics-format prometheus needs solve mode and --out FILE for the result" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Fill the store from any supported format; TSPLIB instances also set tsplib
+bool loadInput(const std::string& input, CityStore& cities, TsplibInstance& tsplib, bool& isTsplib) {
+    isTsplib = endsWith(input, ".tsp");
+    if (isTsplib) {
+        if (!loadTsplibFile(input, tsplib)) return false;
+        tsplibToCityStore(tsplib, cities);
+    } else if (endsWith(input, ".json")) {
+        std::vector<City> loaded;
+        loadCitiesFromJsonFile(input, loaded);
+        cities.assign(loaded);
+    } else {
+        loadCitiesFromXYFile(input, cities);
+    }
+    return !cities.empty();
+}
+
+json resultJson(const SolveResult& result, AssignmentEngine engine, double seconds) {
+    return {
+        {"cities", result.metrics.cities},
+        {"engine", engineName(engine)},
+        {"iterations", result.iterations},
+        {"converged", result.foundTour},
+        {"timed_out", result.timedOut},
+        {"seconds", seconds},
+        {"length", result.length},
+        {"tour", result.tour}
+    };
+}
+
+int runSolve(const CliOptions& options) {
+    CityStore cities;
+    TsplibInstance tsplib;
+    bool isTsplib = false;
+    if (!loadInput(options.input, cities, tsplib, isTsplib)) {
+        std::cerr << "No cities loaded from " << options.input << std::endl;
+        return 1;
+    }
+    if (cities.size() < 2) {
+        std::cerr << "Error: need at least 2 cities, " << options.input << " has " << cities.size() << std::endl;
+        return 1;
+    }
+    std::string error;
+    if (!checkEngineFits(options.solver, cities.size(), error)) {
+        std::cerr << "Error: " << error << std::endl;
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    SolveResult solved = TSPAlgorithm::solveTour(cities, options.solver);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    json result = resultJson(solved, options.solver.engine, seconds);
+    result["input"] = options.input;
+    if (!options.prometheus) result["metrics"] = json::parse(solved.metrics.toJson());
+    if (isTsplib) {
+        result["tsplib_length"] = tsplib.tourLength(solved.tour);
+        long long optimum = tsplibOptimum(tsplib.name);
+        if (optimum > 0) result["tsplib_optimum"] = optimum;
+    }
+
+    if (options.outFile.empty()) {
+        std::cout << result.dump() << std::endl;
+    } else {
+        std::ofstream out(options.outFile);
+        if (!out.is_open()) {
+            std::cerr << "Could not write " << options.outFile << std::endl;
+            return 1;
+        }
+        out << result.dump(2) << std::endl;
+    }
+    if (options.prometheus) std::cout << solved.metrics.toPrometheus() << std::flush;
+
+    std::cerr << (solved.foundTour ? "Converged" : solved.timedOut ? "Time limit reached" : "Iteration limit reached")
+              << " after " << solved.iterations << " iterations, length " << solved.length << std::endl;
+    return 0;
+}
+
+// One batch job: the raw JSON is parsed on the worker, not the reader thread
+struct BatchJob {
+    std::string id;
+    std::string text;
+};
+
+// Jobs are {"id": ..., "cities": [...]} objects or bare city arrays
+bool parseJob(const std::string& text, CityStore& cities, SolverOptions& solver, std::string& id,
+              std::string& error) {
+    json j = json::parse(text, nullptr, false);
+    if (j.is_discarded()) {
+        error = "invalid JSON";
+        return false;
+    }
+    const json* cityArray = &j;
+    if (j.is_object()) {
+        if (j.contains("id")) id = j["id"].is_string() ? j["id"].get<std::string>() : j["id"].dump();
+        if (j.contains("time_limit")) solver.timeLimit = j["time_limit"].get<double>();
+        if (j.contains("max_iterations")) solver.maxIterations = j["max_iterations"].get<int>();
+        if (j.contains("engine") && !parseEngine(j["engine"].get<std::string>(), solver.engine, error)) {
+            return false;
+        }
+        if (!j.contains("cities")) {
+            error = "missing \"cities\"";
+            return false;
+        }
+        cityArray = &j["cities"];
+    }
+    if (!cityArray->is_array()) {
+        error = "\"cities\" is not an array";
+        return false;
+    }
+
+    cities.clear();
+    cities.reserve(cityArray->size(), 0);
+    for (const json& city : *cityArray) {
+        if (!city.contains("x") || !city.contains("y")) {
+            error = "city without x/y";
+            return false;
+        }
+        float x = city["x"].get<float>();
+        float y = city["y"].get<float>();
+        cities.add(x, y, x, y, city.contains("name") ? city["name"].get<std::string>() : std::string());
+    }
+    if (cities.size() < 2) {
+        error = "need at least 2 cities";
+        return false;
+    }
+    return checkEngineFits(solver, cities.size(), error);
+}
+
+int runBatch(const CliOptions& options) {
+    std::ofstream outFile;
+    if (!options.outFile.empty()) {
+        outFile.open(options.outFile);
+        if (!outFile.is_open()) {
+            std::cerr << "Could not write " << options.outFile << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& out = options.outFile.empty() ? std::cout : outFile;
+    std::mutex outMutex;
+    std::atomic<long> solved{0}, failed{0};
+
+    auto run = [&](std::shared_ptr<BatchJob> job) {
+        SolverOptions solver = options.solver;
+        CityStore cities;
+        std::string error;
+        json line;
+        try {
+            if (parseJob(job->text, cities, solver, job->id, error)) {
+                auto start = std::chrono::steady_clock::now();
+                SolveResult result = TSPAlgorithm::solveTour(cities, solver);
+                line = resultJson(result, solver.engine,
+                                  std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+            }
+        } catch (const std::exception& ex) {
+            error = ex.what();
+        }
+        if (!error.empty()) {
+            line = {{"error", error}};
+            failed++;
+        } else {
+            solved++;
+        }
+        line["id"] = job->id;
+
+        std::string text = line.dump();
+        // Flushed per line, so a consumer on a pipe sees each result as it completes
+        std::lock_guard<std::mutex> lock(outMutex);
+        out << text << '\n';
+        out.flush();
+    };
+
+    // Declared after run so the workers are joined before it goes away. A few jobs
+    // per worker stay queued, so the reader never runs far ahead of the solvers.
+    unsigned threads = options.threads ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+    ThreadPool pool(threads, 4 * threads);
+
+    long count = 0;
+    auto submit = [&](std::string id, std::string text) {
+        auto job = std::make_shared<BatchJob>();
+        job->id = std::move(id);
+        job->text = std::move(text);
+        pool.submit([job, &run] { run(job); });
+        count++;
+    };
+
+    if (options.input == "-") {
+        std::string line;
+        while (std::getline(std::cin, line)) {
+            if (line.find_first_not_of(" \t\r") == std::string::npos) continue;
+            submit(std::to_string(count), std::move(line));
+        }
+    } else {
+        std::error_code ec;
+        std::vector<std::filesystem::path> files;
+        for (const auto& entry : std::filesystem::directory_iterator(options.input, ec)) {
+            if (entry.path().extension() == ".json") files.push_back(entry.path());
+        }
+        if (ec) {
+            std::cerr << "Could not read directory " << options.input << ": " << ec.message() << std::endl;
+            return 1;
+        }
+        for (const auto& path : files) {
+            std::ifstream file(path, std::ios::binary);
+            std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+            submit(path.stem().string(), std::move(text));
+        }
+    }
+
+    pool.wait();
+    out.flush();
+    std::cerr << "Batch finished: " << solved << " solved, " << failed << " failed, " << count << " jobs on "
+              << pool.size() << " threads" << std::endl;
+    return failed > 0 ? 2 : 0;
+}
+
+}
+
+int main(int argc, char** argv) {
+    CliOptions options;
+    if (!parseArgs(argc, argv, options)) {
+        printUsage();
+        return 1;
+    }
+    return options.mode == "batch" ? runBatch(options) : runSolve(options);
+}
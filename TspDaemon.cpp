@@ -0,0 +1,372 @@
+// tspd: resident solver daemon on a Unix domain socket (POSIX only).
+//
+//   tspd [--socket /tmp/tspd.sock] [--threads N] [--batch-cities 2048] [--max-inflight 4096]
+//        [--max-cities 5000] [--scratch-dir DIR]
+//
+// Clients send SolverProtocol request frames and get response frames back, on
+// as many connections as they like. One I/O thread reads every connection with
+// poll(). The small requests that arrive in one poll round are grouped into
+// tasks of up to --batch-cities cities, so a burst of 30-city routes costs a
+// handful of pool hand-offs rather than one each. A request's time limit runs
+// from its arrival, so waiting behind others in a batch counts against it.
+// Workers keep their thread_local solver workspaces between requests.
+//
+// Requests above --max-cities are refused with BadRequest: the matrix is
+// O(n^2) memory and the first assignment O(n^3) time, ignoring the time
+// limit. A solve that throws (e.g. std::bad_alloc) is answered with Failed.
+#include "TSPAlgorithm.hpp"
+#include "SolverProtocol.hpp"
+#include "ThreadPool.hpp"
+#include "Logger.hpp"
+#include "SolverWorkspace.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cerrno>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+struct DaemonConfig {
+    std::string socketPath = "/tmp/tspd.sock";
+    unsigned threads = 0;
+    std::size_t batchCities = 2048;   // Requests up to this size are batched together
+    std::size_t maxInflight = 4096;   // Stop reading new requests above this many
+    std::size_t maxCities = 5000;     // Larger requests are refused
+    std::string scratchDirectory;     // Out-of-core distance matrices; empty: system temp
+};
+
+struct Connection {
+    int fd;
+    std::string input;
+    std::string output;
+    std::size_t outstanding;  // Requests still being solved
+    bool eof;                 // Client finished sending; close once everything is answered
+};
+
+struct Job {
+    uint64_t connection;
+    std::chrono::steady_clock::time_point arrival;
+    SolverProtocol::Request request;
+};
+
+// Finished responses, handed from the workers back to the I/O thread
+struct Completions {
+    std::mutex mutex;
+    std::vector<std::pair<uint64_t, std::string>> frames;
+    int wakeFd;
+
+    void push(uint64_t connection, std::string frame) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            frames.emplace_back(connection, std::move(frame));
+        }
+        char byte = 1;
+        // A full pipe already guarantees a wake-up
+        ssize_t ignored = write(wakeFd, &byte, 1);
+        (void)ignored;
+    }
+};
+
+volatile std::sig_atomic_t stopRequested = 0;
+int signalWakeFd = -1;
+
+void onSignal(int) {
+    stopRequested = 1;
+    char byte = 0;
+    ssize_t ignored = write(signalWakeFd, &byte, 1);
+    (void)ignored;
+}
+
+void setNonBlocking(int fd) {
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+}
+
+// Whether the request can be solved as asked; the rest are answered BadRequest
+bool servable(const SolverProtocol::Request& request, const DaemonConfig& config) {
+    if (request.points.size() > config.maxCities) return false;
+    if (!request.options.engineFits(static_cast<int>(request.points.size()))) return false;
+#if !TSP_WITH_MUNKRES
+    // Not compiled in: refuse rather than quietly solving with Hungarian
+    if (request.options.engine == AssignmentEngine::Munkres) return false;
+#endif
+    return true;
+}
+
+SolverProtocol::Response solveRequest(const SolverProtocol::Request& request, CityStore& cities) {
+    const std::size_t n = request.points.size();
+    if (n < 2) {
+        // Nothing to optimise: the (possibly empty) identity tour
+        SolverProtocol::Response response{request.id, SolverProtocol::Status::Converged, 0, 0.0, {}};
+        for (uint32_t i = 0; i < n; i++) response.tour.push_back(i);
+        return response;
+    }
+
+    cities.clear();
+    cities.reserve(n, 0);
+    for (const auto& [x, y] : request.points) cities.add(x, y, x, y, "");
+    return SolverProtocol::makeResponse(request.id, TSPAlgorithm::solveTour(cities, request.options));
+}
+
+// Solve every job of one batch on the calling worker. Every job is answered
+// and counted off, whatever its solve does.
+void runBatch(std::vector<Job>& batch, Completions& completions, std::atomic<std::size_t>& inflight) {
+    static thread_local CityStore cities;
+    std::string frame;
+    for (Job& job : batch) {
+        SolverProtocol::Request& request = job.request;
+        if (request.options.timeLimit > 0.0) {
+            // The limit started when the request arrived; at least the first
+            // assignment still runs once it has passed
+            double waited = std::chrono::duration<double>(std::chrono::steady_clock::now() - job.arrival).count();
+            request.options.timeLimit = std::max(request.options.timeLimit - waited, 1e-9);
+        }
+        SolverProtocol::Response response{request.id, SolverProtocol::Status::Failed, 0, 0.0, {}};
+        try {
+            response = solveRequest(request, cities);
+        } catch (const std::exception& ex) {
+            TSP_LOG(LogLevel::Error, LogCategory::Solver, "Request %llu failed: %s",
+                    static_cast<unsigned long long>(request.id), ex.what());
+            // Whatever the failed solve grew is handed back before the next one
+            cities = CityStore();
+            SolverWorkspace::local().release();
+        }
+        frame.clear();
+        SolverProtocol::encodeResponse(response, frame);
+        completions.push(job.connection, frame);
+        inflight--;
+    }
+}
+
+int listenOn(const std::string& path) {
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) {
+        std::cerr << "Socket path too long: " << path << std::endl;
+        return -1;
+    }
+    std::strcpy(address.sun_path, path.c_str());
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        std::cerr << "socket: " << std::strerror(errno) << std::endl;
+        return -1;
+    }
+    unlink(path.c_str());  // A stale socket from a previous run
+    if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || listen(fd, 128) < 0) {
+        std::cerr << "Cannot listen on " << path << ": " << std::strerror(errno) << std::endl;
+        close(fd);
+        return -1;
+    }
+    setNonBlocking(fd);
+    return fd;
+}
+
+bool parseArgs(int argc, char** argv, DaemonConfig& config) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << std::endl;
+            return false;
+        }
+        std::string value = argv[++i];
+        if (arg == "--socket") config.socketPath = value;
+        else if (arg == "--threads") config.threads = static_cast<unsigned>(std::atoi(value.c_str()));
+        else if (arg == "--batch-cities") config.batchCities = std::strtoul(value.c_str(), nullptr, 10);
+        else if (arg == "--max-inflight") config.maxInflight = std::max(1ul, std::strtoul(value.c_str(), nullptr, 10));
+        else if (arg == "--max-cities") config.maxCities = std::strtoul(value.c_str(), nullptr, 10);
+        else if (arg == "--scratch-dir") config.scratchDirectory = value;
+        else {
+            std::cerr << "Unknown option " << arg << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+}
+
+int main(int argc, char** argv) {
+    DaemonConfig config;
+    if (!parseArgs(argc, argv, config)) {
+        std::cerr << "Usage: tspd [--socket PATH] [--threads N] [--batch-cities N] [--max-inflight N]"
+                  << " [--max-cities N] [--scratch-dir DIR]" << std::endl;
+        return 1;
+    }
+
+    int wakePipe[2];
+    if (pipe(wakePipe) < 0) {
+        std::cerr << "pipe: " << std::strerror(errno) << std::endl;
+        return 1;
+    }
+    setNonBlocking(wakePipe[0]);
+    setNonBlocking(wakePipe[1]);
+    signalWakeFd = wakePipe[1];
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+    std::signal(SIGPIPE, SIG_IGN);
+
+    int listenFd = listenOn(config.socketPath);
+    if (listenFd < 0) return 1;
+
+    Completions completions;
+    completions.wakeFd = wakePipe[1];
+    std::atomic<std::size_t> inflight{0};
+    std::unordered_map<uint64_t, Connection> connections;
+    uint64_t nextConnection = 1;
+    std::vector<Job> pending;
+    std::vector<pollfd> fds;
+    std::vector<uint64_t> fdOwners;
+    std::vector<std::pair<uint64_t, std::string>> finished;
+
+    ThreadPool pool(config.threads);
+    std::cerr << "tspd listening on " << config.socketPath << " with " << pool.size() << " workers" << std::endl;
+
+    while (!stopRequested) {
+        bool acceptingWork = inflight.load() < config.maxInflight;
+        fds.clear();
+        fdOwners.clear();
+        fds.push_back({listenFd, POLLIN, 0});
+        fds.push_back({wakePipe[0], POLLIN, 0});
+        for (const auto& [id, connection] : connections) {
+            short events = (acceptingWork && !connection.eof) ? POLLIN : 0;
+            if (!connection.output.empty()) events |= POLLOUT;
+            fds.push_back({connection.fd, events, 0});
+            fdOwners.push_back(id);
+        }
+
+        if (poll(fds.data(), fds.size(), -1) < 0) {
+            if (errno == EINTR) continue;
+            std::cerr << "poll: " << std::strerror(errno) << std::endl;
+            break;
+        }
+
+        // Drain the wake-up pipe, then queue finished responses for writing
+        if (fds[1].revents & POLLIN) {
+            char drain[256];
+            while (read(wakePipe[0], drain, sizeof(drain)) > 0) {}
+        }
+        {
+            std::lock_guard<std::mutex> lock(completions.mutex);
+            finished.swap(completions.frames);
+        }
+        for (auto& [id, frame] : finished) {
+            auto it = connections.find(id);
+            if (it == connections.end()) continue;  // The client left
+            it->second.output += frame;
+            it->second.outstanding--;
+        }
+        finished.clear();
+
+        if (fds[0].revents & POLLIN) {
+            for (;;) {
+                int fd = accept(listenFd, nullptr, nullptr);
+                if (fd < 0) break;
+                setNonBlocking(fd);
+                connections[nextConnection++] = Connection{fd, std::string(), std::string(), 0, false};
+            }
+        }
+
+        for (size_t k = 0; k < fdOwners.size(); k++) {
+            const pollfd& p = fds[k + 2];
+            auto it = connections.find(fdOwners[k]);
+            Connection& connection = it->second;
+            bool closed = (p.revents & (POLLERR | POLLNVAL)) != 0;
+
+            if (!closed && !connection.eof && (p.revents & (POLLIN | POLLHUP))) {
+                char buffer[65536];
+                for (;;) {
+                    ssize_t got = read(connection.fd, buffer, sizeof(buffer));
+                    if (got > 0) {
+                        connection.input.append(buffer, got);
+                    } else {
+                        if (got == 0) connection.eof = true;
+                        else if (errno != EAGAIN && errno != EWOULDBLOCK) closed = true;
+                        break;
+                    }
+                }
+
+                // Decode every complete frame; a bad header ends the connection
+                size_t offset = 0;
+                for (;;) {
+                    long long size = SolverProtocol::frameSize(connection.input.data() + offset,
+                                                               connection.input.size() - offset,
+                                                               SolverProtocol::REQUEST_MAGIC);
+                    if (size == 0) break;
+                    if (size < 0) {
+                        closed = true;
+                        break;
+                    }
+                    Job job;
+                    job.connection = it->first;
+                    job.arrival = std::chrono::steady_clock::now();
+                    job.request.id = 0;
+                    if (SolverProtocol::decodeRequest(connection.input.data() + offset, size, job.request) &&
+                        servable(job.request, config)) {
+                        job.request.options.scratchDirectory = config.scratchDirectory;
+                        connection.outstanding++;
+                        pending.push_back(std::move(job));
+                    } else {
+                        SolverProtocol::Response error{job.request.id, SolverProtocol::Status::BadRequest, 0, 0.0, {}};
+                        SolverProtocol::encodeResponse(error, connection.output);
+                    }
+                    offset += size;
+                }
+                connection.input.erase(0, offset);
+            }
+
+            if (!closed && !connection.output.empty() && (p.revents & POLLOUT)) {
+                ssize_t sent = write(connection.fd, connection.output.data(), connection.output.size());
+                if (sent > 0) connection.output.erase(0, sent);
+                else if (sent < 0 && errno != EAGAIN && errno != EWOULDBLOCK) closed = true;
+            }
+
+            if (connection.eof && connection.outstanding == 0 && connection.output.empty()) closed = true;
+            if (closed) {
+                close(connection.fd);
+                connections.erase(it);
+            }
+        }
+
+        // Small requests from this round share tasks; large ones get their own
+        std::vector<Job> batch;
+        std::size_t batchCities = 0;
+        auto flush = [&] {
+            if (batch.empty()) return;
+            inflight += batch.size();
+            auto shared = std::make_shared<std::vector<Job>>(std::move(batch));
+            pool.submit([shared, &completions, &inflight] { runBatch(*shared, completions, inflight); });
+            batch.clear();
+            batchCities = 0;
+        };
+        for (Job& job : pending) {
+            std::size_t size = job.request.points.size();
+            if (batchCities + size > config.batchCities) flush();
+            batchCities += size;
+            batch.push_back(std::move(job));
+        }
+        flush();
+        pending.clear();
+    }
+
+    std::cerr << "tspd shutting down" << std::endl;
+    close(listenFd);
+    unlink(config.socketPath.c_str());
+    pool.wait();
+    for (auto& [id, connection] : connections) close(connection.fd);
+    return 0;
+}
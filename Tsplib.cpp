@@ -0,0 +1,135 @@
+#include "Tsplib.hpp"
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace {
+
+std::string trim(const std::string& s) {
+    size_t begin = s.find_first_not_of(" \t\r");
+    if (begin == std::string::npos) return "";
+    size_t end = s.find_last_not_of(" \t\r");
+    return s.substr(begin, end - begin + 1);
+}
+
+// Optimal tour lengths from the TSPLIB 95 distribution
+const std::pair<const char*, long long> KNOWN_OPTIMA[] = {
+    {"eil51", 426},      {"berlin52", 7542},   {"st70", 675},       {"eil76", 538},
+    {"pr76", 108159},    {"rat99", 1211},      {"kroA100", 21282},  {"kroB100", 22141},
+    {"kroC100", 20749},  {"kroD100", 21294},   {"kroE100", 22068},  {"rd100", 7910},
+    {"eil101", 629},     {"lin105", 14379},    {"ch130", 6110},     {"ch150", 6528},
+    {"pr152", 73682},    {"d198", 15780},      {"a280", 2579},      {"lin318", 42029},
+    {"pcb442", 50778},   {"rat783", 8806},     {"pr1002", 259045},
+};
+
+}
+
+long long TsplibInstance::distance(int i, int j) const {
+    double dx = coords[i].first - coords[j].first;
+    double dy = coords[i].second - coords[j].second;
+    if (edgeWeightType == "CEIL_2D") {
+        return static_cast<long long>(std::ceil(std::sqrt(dx * dx + dy * dy)));
+    }
+    if (edgeWeightType == "ATT") {
+        double r = std::sqrt((dx * dx + dy * dy) / 10.0);
+        long long t = static_cast<long long>(std::lround(r));
+        return t < r ? t + 1 : t;
+    }
+    // EUC_2D: nearest integer
+    return static_cast<long long>(std::sqrt(dx * dx + dy * dy) + 0.5);
+}
+
+long long TsplibInstance::tourLength(const std::vector<int>& tour) const {
+    long long length = 0;
+    for (size_t i = 0; i < tour.size(); i++) {
+        length += distance(tour[i], tour[(i + 1) % tour.size()]);
+    }
+    return length;
+}
+
+bool loadTsplibFile(const std::string& filename, TsplibInstance& instance) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Could not open " << filename << std::endl;
+        return false;
+    }
+
+    instance = TsplibInstance();
+    int dimension = 0;
+    std::string line;
+
+    // Header: "KEY : VALUE" lines up to the first section
+    while (std::getline(file, line)) {
+        line = trim(line);
+        if (line == "NODE_COORD_SECTION") break;
+        if (line == "EOF" || line.find("_SECTION") != std::string::npos) {
+            std::cerr << filename << ": no NODE_COORD_SECTION" << std::endl;
+            return false;
+        }
+        size_t colon = line.find(':');
+        if (colon == std::string::npos) continue;
+        std::string key = trim(line.substr(0, colon));
+        std::string value = trim(line.substr(colon + 1));
+        if (key == "NAME") instance.name = value;
+        else if (key == "DIMENSION") dimension = std::atoi(value.c_str());
+        else if (key == "EDGE_WEIGHT_TYPE") instance.edgeWeightType = value;
+        else if (key == "TYPE" && value != "TSP") {
+            std::cerr << filename << ": unsupported type " << value << std::endl;
+            return false;
+        }
+    }
+
+    const std::string& type = instance.edgeWeightType;
+    if (type != "EUC_2D" && type != "CEIL_2D" && type != "ATT") {
+        std::cerr << filename << ": unsupported EDGE_WEIGHT_TYPE " << type << std::endl;
+        return false;
+    }
+    if (dimension <= 0) {
+        std::cerr << filename << ": missing DIMENSION" << std::endl;
+        return false;
+    }
+
+    // Nodes are numbered 1..DIMENSION, normally but not necessarily in order
+    instance.coords.assign(dimension, {0.0, 0.0});
+    std::vector<char> seen(dimension, 0);
+    int count = 0;
+    while (count < dimension && std::getline(file, line)) {
+        line = trim(line);
+        if (line.empty()) continue;
+        if (line == "EOF") break;
+        std::istringstream in(line);
+        int id;
+        double x, y;
+        if (!(in >> id >> x >> y) || id < 1 || id > dimension || seen[id - 1]) {
+            std::cerr << filename << ": bad node line '" << line << "'" << std::endl;
+            return false;
+        }
+        instance.coords[id - 1] = {x, y};
+        seen[id - 1] = 1;
+        count++;
+    }
+    if (count != dimension) {
+        std::cerr << filename << ": expected " << dimension << " nodes, found " << count << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void tsplibToCityStore(const TsplibInstance& instance, CityStore& cities) {
+    cities.clear();
+    cities.reserve(instance.size(), instance.size() * 5);
+    for (int i = 0; i < instance.size(); i++) {
+        float x = static_cast<float>(instance.coords[i].first);
+        float y = static_cast<float>(instance.coords[i].second);
+        cities.add(x, y, x, y, std::to_string(i + 1));
+    }
+}
+
+long long tsplibOptimum(const std::string& name) {
+    for (const auto& known : KNOWN_OPTIMA) {
+        if (name == known.first) return known.second;
+    }
+    return -1;
+}
@@ -0,0 +1,31 @@
+#ifndef TSPLIB_HPP
+#define TSPLIB_HPP
+
+#include "CityStore.hpp"
+#include <string>
+#include <vector>
+#include <utility>
+
+// A TSPLIB instance given by node coordinates (EUC_2D, CEIL_2D or ATT).
+// Lengths use the TSPLIB integer distance functions, so they are directly
+// comparable with the published optima.
+struct TsplibInstance {
+    std::string name;
+    std::string edgeWeightType;
+    std::vector<std::pair<double, double>> coords;
+
+    int size() const { return static_cast<int>(coords.size()); }
+    long long distance(int i, int j) const;
+    long long tourLength(const std::vector<int>& tour) const;
+};
+
+// Read a .tsp file; returns false (and says why) if the file is unsupported
+bool loadTsplibFile(const std::string& filename, TsplibInstance& instance);
+
+// Cities named by their TSPLIB node number (1-based)
+void tsplibToCityStore(const TsplibInstance& instance, CityStore& cities);
+
+// Published optimal tour length, or -1 if the instance is not in the table
+long long tsplibOptimum(const std::string& name);
+
+#endif // TSPLIB_HPP
@@ -0,0 +1,234 @@
+// TSPLIB quality benchmark: runs each assignment engine over the .tsp files in a
+// directory and reports the gap to the published optimum against solver time
+// (wall clock, steady_clock).
+//
+//   TsplibBench [directory=tsplib] [--engines hungarian,munkres] [--time-limit 60]
+//               [--max-iterations 5000] [--out results.json]
+//
+// After every patching iteration the current subtours are spliced into a tour
+// (TSPAlgorithm::mergeSubtours), giving an anytime curve of the best tour so
+// far. The splicing is not counted in the solver time.
+//
+// With no .tsp files in the directory the harness runs tsplib/fetch.sh to
+// download the instances, and fails if that does not produce any.
+#include "TSPAlgorithm.hpp"
+#include "SolverWorkspace.hpp"
+#include "Tsplib.hpp"
+#include "Logger.hpp"
+#include "json.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+using json = nlohmann::json;
+
+namespace {
+
+struct HarnessConfig {
+    std::string directory = "tsplib";
+#if TSP_WITH_MUNKRES
+    std::vector<AssignmentEngine> engines{AssignmentEngine::Hungarian, AssignmentEngine::Munkres};
+#else
+    std::vector<AssignmentEngine> engines{AssignmentEngine::Hungarian};
+#endif
+    double timeLimit = 60.0;  // Solver seconds per instance and engine
+    int maxIterations = 5000;
+    std::string outFile;
+};
+
+const char* engineName(AssignmentEngine engine) {
+    return engine == AssignmentEngine::Munkres ? "munkres" : "hungarian";
+}
+
+// std::clock is CPU time on POSIX but wall time on Windows; use one clock everywhere
+double wallSeconds() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+std::vector<std::string> findInstances(const std::string& directory) {
+    std::vector<std::string> files;
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, ec)) {
+        if (entry.path().extension() == ".tsp") files.push_back(entry.path().string());
+    }
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+// Download the instances with the fetch script next to them (or tsplib/fetch.sh)
+bool fetchInstances(const std::string& directory) {
+#ifdef _WIN32
+    (void)directory;
+    return false;
+#else
+    std::filesystem::path script = std::filesystem::path(directory) / "fetch.sh";
+    if (!std::filesystem::exists(script)) script = "tsplib/fetch.sh";
+    if (!std::filesystem::exists(script)) return false;
+    std::string command = "sh '" + script.string() + "' '" + directory + "'";
+    std::cerr << "No .tsp files in " << directory << ", running " << script.string() << std::endl;
+    return std::system(command.c_str()) == 0;
+#endif
+}
+
+double gapPercent(long long length, long long optimum) {
+    return optimum > 0 ? 100.0 * (length - optimum) / optimum : -1.0;
+}
+
+json runInstance(const TsplibInstance& instance, const CityStore& cities, AssignmentEngine engine,
+                 const HarnessConfig& config, SolverWorkspace& ws) {
+    const long long optimum = tsplibOptimum(instance.name);
+    SolverOptions options;
+    options.engine = engine;
+    options.maxIterations = config.maxIterations;
+
+    HungarianStepper stepper(cities, ws, options);
+    std::vector<int> tour;
+    long long best = -1;
+    double solverSeconds = 0.0;
+    bool timedOut = false;
+    json curve = json::array();
+
+    for (;;) {
+        double start = wallSeconds();
+        bool produced = stepper.next();
+        solverSeconds += wallSeconds() - start;
+        if (!produced) break;
+
+        TSPAlgorithm::mergeSubtours(cities, stepper.subtours(), tour);
+        long long length = instance.tourLength(tour);
+        if (best < 0 || length < best) best = length;
+
+        curve.push_back({
+            {"iteration", stepper.iteration()},
+            {"seconds", solverSeconds},
+            {"subtours", stepper.subtours().count()},
+            {"length", length},
+            {"best_length", best},
+            {"gap_percent", gapPercent(best, optimum)}
+        });
+
+        if (solverSeconds > config.timeLimit) {
+            timedOut = true;
+            break;
+        }
+    }
+
+    return {
+        {"instance", instance.name},
+        {"engine", engineName(engine)},
+        {"cities", instance.size()},
+        {"optimum", optimum},
+        {"iterations", stepper.iteration() + 1},
+        {"seconds", solverSeconds},
+        {"converged", stepper.foundTour()},
+        {"timed_out", timedOut},
+        {"best_length", best},
+        {"gap_percent", gapPercent(best, optimum)},
+        {"curve", curve}
+    };
+}
+
+bool parseArgs(int argc, char** argv, HarnessConfig& config) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg.rfind("--", 0) != 0) {
+            config.directory = arg;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << std::endl;
+            return false;
+        }
+        std::string value = argv[++i];
+        if (arg == "--time-limit") config.timeLimit = std::atof(value.c_str());
+        else if (arg == "--max-iterations") config.maxIterations = std::max(1, std::atoi(value.c_str()));
+        else if (arg == "--out") config.outFile = value;
+        else if (arg == "--engines") {
+            config.engines.clear();
+            std::stringstream in(value);
+            std::string item;
+            while (std::getline(in, item, ',')) {
+                if (item == "hungarian") config.engines.push_back(AssignmentEngine::Hungarian);
+                else if (item == "munkres") {
+#if TSP_WITH_MUNKRES
+                    config.engines.push_back(AssignmentEngine::Munkres);
+#else
+                    std::cerr << "Engine munkres is not available (built without munkres-cpp)" << std::endl;
+                    return false;
+#endif
+                }
+                else {
+                    std::cerr << "Unknown engine " << item << std::endl;
+                    return false;
+                }
+            }
+        } else {
+            std::cerr << "Unknown option " << arg << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+}
+
+int main(int argc, char** argv) {
+    HarnessConfig config;
+    if (!parseArgs(argc, argv, config)) return 1;
+
+    Log::setLevel(LogLevel::Off);
+
+    std::vector<std::string> files = findInstances(config.directory);
+    if (files.empty() && fetchInstances(config.directory)) files = findInstances(config.directory);
+    if (files.empty()) {
+        std::cerr << "ERROR: no TSPLIB instances in " << config.directory
+                  << " and tsplib/fetch.sh could not download them; see tsplib/README.md" << std::endl;
+        return 1;
+    }
+
+    SolverWorkspace ws;
+    TsplibInstance instance;
+    CityStore cities;
+    json runs = json::array();
+
+    std::cerr << std::left << std::setw(12) << "instance" << std::setw(11) << "engine"
+              << std::setw(10) << "optimum" << std::setw(10) << "best" << std::setw(9) << "gap %"
+              << std::setw(7) << "iters" << "seconds" << std::endl;
+    for (const std::string& file : files) {
+        if (!loadTsplibFile(file, instance)) continue;
+        if (instance.name.empty()) instance.name = std::filesystem::path(file).stem().string();
+        tsplibToCityStore(instance, cities);
+
+        for (AssignmentEngine engine : config.engines) {
+            json run = runInstance(instance, cities, engine, config, ws);
+            std::cerr << std::left << std::setw(12) << instance.name << std::setw(11) << engineName(engine)
+                      << std::setw(10) << run["optimum"].get<long long>()
+                      << std::setw(10) << run["best_length"].get<long long>()
+                      << std::setw(9) << std::fixed << std::setprecision(2) << run["gap_percent"].get<double>()
+                      << std::setw(7) << run["iterations"].get<int>()
+                      << std::setprecision(3) << run["seconds"].get<double>()
+                      << (run["timed_out"].get<bool>() ? " (time limit)" : "") << std::endl;
+            runs.push_back(std::move(run));
+        }
+        ws.release();
+    }
+
+    json report = {
+        {"time_limit", config.timeLimit},
+        {"max_iterations", config.maxIterations},
+        {"runs", runs}
+    };
+    if (config.outFile.empty()) {
+        std::cout << report.dump(2) << std::endl;
+    } else {
+        std::ofstream out(config.outFile);
+        out << report.dump(2) << std::endl;
+    }
+    return 0;
+}
@@ -19,25 +19,81 @@ echo Compiling City.cpp...
 g++ %CFLAGS% -c City.cpp -o City.o -I.
 if %errorlevel% neq 0 goto error
 
+echo Compiling CityStore.cpp...
+g++ %CFLAGS% -c CityStore.cpp -o CityStore.o -I.
+if %errorlevel% neq 0 goto error
+
+echo Compiling MappedMatrix.cpp...
+g++ %CFLAGS% -c MappedMatrix.cpp -o MappedMatrix.o -I.
+if %errorlevel% neq 0 goto error
+
+echo Compiling AssignmentBackend.cpp...
+g++ %CFLAGS% -c AssignmentBackend.cpp -o AssignmentBackend.o -I. -Imunkres-cpp/src
+if %errorlevel% neq 0 goto error
+
+echo Compiling Logger.cpp...
+g++ %CFLAGS% -c Logger.cpp -o Logger.o -I.
+if %errorlevel% neq 0 goto error
+
 echo Compiling TSPAlgorithm.cpp...
 g++ %CFLAGS% -c TSPAlgorithm.cpp -o TSPAlgorithm.o -I. -Imunkres-cpp/src
 if %errorlevel% neq 0 goto error
 
+echo Compiling StepHistory.cpp...
+g++ %CFLAGS% -c StepHistory.cpp -o StepHistory.o -I. -Imunkres-cpp/src
+if %errorlevel% neq 0 goto error
+
+echo Compiling SolverMetrics.cpp...
+g++ %CFLAGS% -c SolverMetrics.cpp -o SolverMetrics.o -I.
+if %errorlevel% neq 0 goto error
+
 echo Compiling MatrixPanel.cpp...
 g++ %CFLAGS% -c MatrixPanel.cpp -o MatrixPanel.o -I. -Ifreeglut/include
 if %errorlevel% neq 0 goto error
 
+echo Compiling Quadtree.cpp...
+g++ %CFLAGS% -c Quadtree.cpp -o Quadtree.o -I.
+if %errorlevel% neq 0 goto error
+
+echo Compiling TourPyramid.cpp...
+g++ %CFLAGS% -c TourPyramid.cpp -o TourPyramid.o -I.
+if %errorlevel% neq 0 goto error
+
+echo Compiling ThreadPool.cpp...
+g++ %CFLAGS% -c ThreadPool.cpp -o ThreadPool.o -I.
+if %errorlevel% neq 0 goto error
+
+echo Compiling DensityRaster.cpp...
+g++ %CFLAGS% -c DensityRaster.cpp -o DensityRaster.o -I. -Ifreeglut/include
+if %errorlevel% neq 0 goto error
+
+echo Compiling MatrixHeatmap.cpp...
+g++ %CFLAGS% -c MatrixHeatmap.cpp -o MatrixHeatmap.o -I. -Ifreeglut/include
+if %errorlevel% neq 0 goto error
+
+echo Compiling CityRenderer.cpp...
+g++ %CFLAGS% -c CityRenderer.cpp -o CityRenderer.o -I. -Ifreeglut/include
+if %errorlevel% neq 0 goto error
+
 echo Compiling RenderUtils.cpp...
 g++ %CFLAGS% -c RenderUtils.cpp -o RenderUtils.o -I. -Ifreeglut/include
 if %errorlevel% neq 0 goto error
 
+echo Compiling FrameScheduler.cpp...
+g++ %CFLAGS% -c FrameScheduler.cpp -o FrameScheduler.o -I. -Ifreeglut/include
+if %errorlevel% neq 0 goto error
+
+echo Compiling SalesmanPath.cpp...
+g++ %CFLAGS% -c SalesmanPath.cpp -o SalesmanPath.o -I.
+if %errorlevel% neq 0 goto error
+
 echo Compiling munkres.cpp...
 g++ %CFLAGS% -c munkres-cpp/src/munkres.cpp -o munkres.o -Imunkres-cpp/src
 if %errorlevel% neq 0 goto error
 
 echo.
 echo Linking with FreeGLUT DLL...
-g++ ComputerGraphics.o City.o TSPAlgorithm.o MatrixPanel.o RenderUtils.o munkres.o -o ComputerGraphics.exe -L. -lfreeglut -lopengl32 -lglu32 -lwinmm -lgdi32
+g++ ComputerGraphics.o City.o CityStore.o MappedMatrix.o AssignmentBackend.o TSPAlgorithm.o StepHistory.o Logger.o SolverMetrics.o MatrixPanel.o MatrixHeatmap.o Quadtree.o TourPyramid.o ThreadPool.o DensityRaster.o CityRenderer.o RenderUtils.o FrameScheduler.o SalesmanPath.o munkres.o -o ComputerGraphics.exe -L. -lfreeglut -lopengl32 -lglu32 -lwinmm -lgdi32
 if %errorlevel% neq 0 goto error
 
 echo.
@@ -0,0 +1,42 @@
+#!/bin/sh
+# Download the TSPLIB instances that Tsplib.cpp has optima for into this
+# directory (or the one given as $1). TsplibBench runs this when it finds no
+# .tsp files. Any failure is fatal: a partial set would silently skew the
+# averages, so the script stops with a non-zero status and says what is missing.
+#
+#   tsplib/fetch.sh [directory]
+#   TSPLIB_MIRROR=https://example.org/tsp tsplib/fetch.sh   # another copy of .../TSPLIB95/tsp
+set -u
+
+DIR=${1:-$(dirname "$0")}
+MIRROR=${TSPLIB_MIRROR:-http://comopt.ifi.uni-heidelberg.de/software/TSPLIB95/tsp}
+INSTANCES="eil51 berlin52 st70 eil76 pr76 rat99 kroA100 kroB100 kroC100 kroD100 kroE100 rd100
+eil101 lin105 ch130 ch150 pr152 d198 a280 lin318 pcb442 rat783 pr1002"
+
+fail() {
+    echo "tsplib/fetch.sh: ERROR: $*" >&2
+    echo "tsplib/fetch.sh: download the instances by hand from $MIRROR into $DIR" >&2
+    exit 1
+}
+
+if command -v curl >/dev/null 2>&1; then
+    download() { curl -fsSL -o "$2" "$1"; }
+elif command -v wget >/dev/null 2>&1; then
+    download() { wget -q -O "$2" "$1"; }
+else
+    fail "neither curl nor wget is installed"
+fi
+command -v gzip >/dev/null 2>&1 || fail "gzip is not installed"
+
+mkdir -p "$DIR" || fail "cannot create $DIR"
+for name in $INSTANCES; do
+    target="$DIR/$name.tsp"
+    [ -s "$target" ] && continue
+    echo "Fetching $name" >&2
+    download "$MIRROR/$name.tsp.gz" "$target.gz" || { rm -f "$target.gz"; fail "could not download $name"; }
+    gzip -dc "$target.gz" > "$target" || { rm -f "$target" "$target.gz"; fail "$name.tsp.gz is not a gzip file"; }
+    rm -f "$target.gz"
+    # A mirror's error page instead of the instance must not pass for data
+    grep -q "NODE_COORD_SECTION" "$target" || { rm -f "$target"; fail "$name.tsp has no NODE_COORD_SECTION"; }
+done
+echo "All TSPLIB instances present in $DIR" >&2